@@ -0,0 +1,550 @@
+/*
+ *  Archetype
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef ARCHETYPE_HPP_
+    #define ARCHETYPE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <array>
+#include <span>
+#include <ranges>
+#include <unordered_map>
+#include <algorithm>
+#include <string>
+
+#include "Includes.hpp"
+#include "Errors.hpp"
+#include "Component.hpp"
+
+namespace ECS {
+
+    /**
+     * @brief How a world stores its components, see ECS::ECS()
+     */
+    enum class StorageMode {
+        SPARSE_SET,             // One sparse set per component type, cheap structural changes
+        ARCHETYPE               // Entities with the same signature share chunks, cheap multi-component iteration
+    };
+
+    #ifndef BLOB_ECS_ARCHETYPE_CHUNK_SIZE
+        #define BLOB_ECS_ARCHETYPE_CHUNK_SIZE 16384
+    #endif
+    // Size in bytes of an archetype chunk, larger if a single row doesn't fit
+    constexpr std::size_t ARCHETYPE_CHUNK_SIZE = BLOB_ECS_ARCHETYPE_CHUNK_SIZE;
+
+    /**
+     * @brief Type-erased operations on the cells of a component column
+     */
+    struct ColumnType {
+        std::size_t size = 0;
+        std::size_t align = 1;
+        void (*construct)(void *) = nullptr;
+        void (*relocate)(void *dst, void *src) = nullptr;       // Move-constructs dst from src, then destroys src
+        void (*destroy)(void *) = nullptr;
+
+        template<ComponentType T>
+        static ColumnType of() {
+            return ColumnType{
+                sizeof(T),
+                alignof(T),
+                [](void *cell) { new (cell) T(); },
+                [](void *dst, void *src) {
+                    new (dst) T(std::move(*static_cast<T *>(src)));
+                    static_cast<T *>(src)->~T();
+                },
+                [](void *cell) { static_cast<T *>(cell)->~T(); }
+            };
+        }
+    };
+
+    /**
+     * @brief Every entity that has exactly the same set of components
+     *
+     * Rows are packed in fixed-size chunks, each chunk holds the entity IDs
+     * then one cache line aligned column per component.
+     * Removing a row moves the last row in its place.
+     */
+    class Archetype {
+        public:
+            static constexpr uint16_t NULL_COLUMN = std::numeric_limits<uint16_t>::max();
+
+            /**
+             * @brief Construct a new Archetype object
+             *
+             * @param mask The signature of the archetype
+             * @param types The column types, indexed by slot
+             * @param resource The memory resource the chunks are allocated from
+             */
+            Archetype(const ComponentMask &mask, std::span<const ColumnType> types, std::pmr::memory_resource *resource)
+            : m_mask(mask), m_resource(resource)
+            {
+                m_column_of.fill(NULL_COLUMN);
+                mask.forEach([&](std::size_t slot) {
+                    m_column_of[slot] = static_cast<uint16_t>(m_slots.size());
+                    m_slots.push_back(static_cast<uint16_t>(slot));
+                    m_types.push_back(types[slot]);
+                    m_chunk_align = std::max(m_chunk_align, types[slot].align);
+                });
+                m_offsets.resize(m_slots.size());
+
+                std::size_t row_size = sizeof(EntityID);
+
+                for (const ColumnType &it : m_types)
+                    row_size += it.size;
+                m_capacity = std::max<std::size_t>(ARCHETYPE_CHUNK_SIZE / row_size, 1);
+                while (m_capacity > 1 && layout(m_capacity) > ARCHETYPE_CHUNK_SIZE)
+                    m_capacity--;
+                m_chunk_bytes = std::max(layout(m_capacity), ARCHETYPE_CHUNK_SIZE);
+            }
+
+            ~Archetype() {
+                for (std::size_t row = 0; row < m_size; row++) {
+                    for (std::size_t column = 0; column < m_types.size(); column++)
+                        m_types[column].destroy(cell(column, row));
+                }
+                for (std::byte *chunk : m_chunks)
+                    m_resource->deallocate(chunk, m_chunk_bytes, m_chunk_align);
+            }
+
+            Archetype(const Archetype &) = delete;
+            Archetype &operator=(const Archetype &) = delete;
+
+            const ComponentMask &mask() const { return m_mask; }
+
+            // Amount of rows, i.e. entities
+            std::size_t size() const { return m_size; }
+
+            // Amount of rows a chunk holds
+            std::size_t chunkCapacity() const { return m_capacity; }
+
+            std::size_t chunkCount() const { return (m_size + m_capacity - 1) / m_capacity; }
+
+            // Amount of rows in use within a chunk
+            std::size_t chunkSize(std::size_t chunk) const {
+                return std::min(m_capacity, m_size - chunk * m_capacity);
+            }
+
+            /**
+             * @brief Returns the column standing for a slot, NULL_COLUMN if the archetype doesn't have the component
+             */
+            uint16_t columnOf(std::size_t slot) const { return m_column_of[slot]; }
+
+            EntityID *entities(std::size_t chunk) {
+                return std::launder(reinterpret_cast<EntityID *>(m_chunks[chunk]));
+            }
+
+            EntityID entityAt(std::size_t row) const {
+                return std::launder(reinterpret_cast<const EntityID *>(m_chunks[row / m_capacity]))[row % m_capacity];
+            }
+
+            /**
+             * @brief Returns the first cell of a column within a chunk, the chunkSize() next ones are in use
+             *
+             * @tparam T The component type stored in the column
+             * @param chunk The chunk index
+             * @param column The column, see columnOf()
+             */
+            template<ComponentType T>
+            T *columnData(std::size_t chunk, std::size_t column) {
+                return std::launder(reinterpret_cast<T *>(m_chunks[chunk] + m_offsets[column]));
+            }
+
+            template<ComponentType T>
+            T &componentAt(std::size_t column, std::size_t row) {
+                return *std::launder(static_cast<T *>(cell(column, row)));
+            }
+
+        private:
+            friend class ArchetypeStorage;
+
+            ComponentMask m_mask;
+            std::pmr::memory_resource *m_resource;
+            std::vector<uint16_t> m_slots;                              // Slot of each column, increasing
+            std::vector<ColumnType> m_types;                            // Type of each column
+            std::vector<std::size_t> m_offsets;                         // Byte offset of each column within a chunk
+            std::array<uint16_t, MAX_COMPONENTS> m_column_of;           // Slot -> column
+            std::size_t m_capacity = 1;
+            std::size_t m_chunk_bytes = 0;
+            std::size_t m_chunk_align = CACHE_LINE_SIZE;
+            std::size_t m_size = 0;
+            std::vector<std::byte *> m_chunks;
+            std::vector<uint32_t> m_add_edges;                          // Slot -> archetype with it added, filled lazily
+            std::vector<uint32_t> m_remove_edges;                       // Slot -> archetype with it removed, filled lazily
+
+            /**
+             * @brief Computes the column offsets for a given amount of rows per chunk
+             *
+             * @return std::size_t The chunk size needed
+             */
+            std::size_t layout(std::size_t rows) {
+                std::size_t offset = rows * sizeof(EntityID);
+
+                for (std::size_t column = 0; column < m_types.size(); column++) {
+                    std::size_t align = std::max(m_types[column].align, CACHE_LINE_SIZE);
+
+                    offset = (offset + align - 1) / align * align;
+                    m_offsets[column] = offset;
+                    offset += rows * m_types[column].size;
+                }
+                return offset;
+            }
+
+            void *cell(std::size_t column, std::size_t row) {
+                return m_chunks[row / m_capacity] + m_offsets[column] + (row % m_capacity) * m_types[column].size;
+            }
+
+            /**
+             * @brief Appends a row, its cells are left unconstructed
+             *
+             * @return std::size_t The row index
+             */
+            std::size_t pushRow(EntityID e) {
+                if (m_size == m_chunks.size() * m_capacity)
+                    m_chunks.push_back(static_cast<std::byte *>(m_resource->allocate(m_chunk_bytes, m_chunk_align)));
+                new (entities(m_size / m_capacity) + m_size % m_capacity) EntityID(e);
+                return m_size++;
+            }
+
+            /**
+             * @brief Releases the chunks past the last row, rows never move
+             */
+            void shrink() {
+                std::size_t needed = (m_size + m_capacity - 1) / m_capacity;
+
+                while (m_chunks.size() > needed) {
+                    m_resource->deallocate(m_chunks.back(), m_chunk_bytes, m_chunk_align);
+                    m_chunks.pop_back();
+                }
+                m_chunks.shrink_to_fit();
+            }
+
+            /**
+             * @brief Removes a row whose cells were already destroyed or moved out, the last row takes its place
+             *
+             * @param row The row index
+             * @return EntityID The entity moved to that row, NULL_ENTITY if the removed row was the last one
+             */
+            EntityID eraseRow(std::size_t row) {
+                std::size_t last = m_size - 1;
+                EntityID moved = NULL_ENTITY;
+
+                if (row != last) {
+                    for (std::size_t column = 0; column < m_types.size(); column++)
+                        m_types[column].relocate(cell(column, row), cell(column, last));
+                    moved = entityAt(last);
+                    entities(row / m_capacity)[row % m_capacity] = moved;
+                }
+                m_size--;
+                return moved;
+            }
+    };
+
+    /**
+     * @brief Archetype storage backend, entities are grouped by signature in chunked archetypes
+     *
+     * Adding or removing a component moves the entity's row to another archetype,
+     * the transitions are cached on the archetypes. References to components are
+     * invalidated by any structural change of an entity of the same archetype.
+     */
+    class ArchetypeStorage {
+        public:
+            ArchetypeStorage(SignatureTable &signatures)
+            : m_signatures(signatures)
+            {
+                m_root_edges.assign(MAX_COMPONENTS, NULL_INDEX);
+            }
+
+            ArchetypeStorage(const ArchetypeStorage &) = delete;
+            ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+
+            /**
+             * @brief Declares the type stored for a slot
+             *
+             * @tparam T The component type
+             * @param slot The slot of the type
+             */
+            template<ComponentType T>
+            void registerColumn(std::size_t slot) {
+                if (slot >= m_types.size())
+                    m_types.resize(slot + 1);
+                m_types[slot] = ColumnType::of<T>();
+            }
+
+            /**
+             * @brief Sets the memory resource new archetypes allocate their chunks from
+             */
+            void setMemoryResource(std::pmr::memory_resource *resource) {
+                m_resource = resource;
+            }
+
+            /**
+             * @brief Releases the chunks no row uses, and the locations past the entity indices in use
+             *
+             * @param extent The entity indices in use are lower than this
+             * @param utilization The fraction of the capacity under which the location table is shrunk
+             */
+            void shrink(std::size_t extent, float utilization) {
+                for (const auto &it : m_archetypes)
+                    it->shrink();
+                if (m_locations.size() > extent)
+                    m_locations.resize(extent);
+                if (static_cast<float>(m_locations.size()) < static_cast<float>(m_locations.capacity()) * utilization)
+                    m_locations.shrink_to_fit();
+            }
+
+            /**
+             * @brief Checks if a handle is the one stored in the archetypes, stale handles never are
+             */
+            bool hasEntity(EntityID e) const {
+                EntityIndex index = entityIndex(e);
+
+                return index < m_locations.size() && m_locations[index].archetype != NULL_INDEX
+                    && m_archetypes[m_locations[index].archetype]->entityAt(m_locations[index].row) == e;
+            }
+
+            bool hasComponent(EntityID e, std::size_t slot) const {
+                return hasEntity(e) && m_archetypes[m_locations[entityIndex(e)].archetype]->columnOf(slot) != Archetype::NULL_COLUMN;
+            }
+
+            /**
+             * @brief Adds a default-constructed component to an entity, moving it to the matching archetype
+             *
+             * @tparam T The component type
+             * @param e The entity ID, must be alive
+             * @param slot The slot of the type
+             * @return T& Reference to the newly created component
+             * @throw ERROR::ComponentAlreadyAttached => if the entity already has the component
+             */
+            template<ComponentType T>
+            T &addComponent(EntityID e, std::size_t slot) {
+                if (hasComponent(e, slot))
+                    throw ERROR::ComponentAlreadyAttached(e, std::string(typeid(T).name()));
+
+                EntityIndex index = entityIndex(e);
+
+                if (index >= m_locations.size())
+                    m_locations.resize(std::max<std::size_t>(index + 1, m_locations.size() * 2));
+
+                uint32_t from = m_locations[index].archetype;
+                uint32_t to = transition(from, slot, true);
+
+                moveEntity(e, from, to);
+                m_signatures.set(index, slot);
+
+                Archetype &archetype = *m_archetypes[to];
+                return archetype.componentAt<T>(archetype.columnOf(slot), m_locations[index].row);
+            }
+
+            /**
+             * @brief Get the component attached to an entity, the entity must have it
+             */
+            template<ComponentType T>
+            T &getComponent(EntityID e, std::size_t slot) {
+                const Location &location = m_locations[entityIndex(e)];
+                Archetype &archetype = *m_archetypes[location.archetype];
+
+                return archetype.componentAt<T>(archetype.columnOf(slot), location.row);
+            }
+
+            /**
+             * @brief Removes a component from an entity, moving it to the matching archetype
+             *
+             * @param e The entity ID
+             * @param slot The slot of the type
+             */
+            void removeComponent(EntityID e, std::size_t slot) {
+                if (!hasComponent(e, slot))
+                    return;
+
+                EntityIndex index = entityIndex(e);
+                uint32_t from = m_locations[index].archetype;
+
+                moveEntity(e, from, transition(from, slot, false));
+                m_signatures.reset(index, slot);
+            }
+
+            /**
+             * @brief Destroys every component of an entity
+             *
+             * @param e The entity ID
+             */
+            void removeEntity(EntityID e) {
+                if (!hasEntity(e))
+                    return;
+
+                EntityIndex index = entityIndex(e);
+
+                m_archetypes[m_locations[index].archetype]->mask().forEach([&](std::size_t slot) {
+                    m_signatures.reset(index, slot);
+                });
+                moveEntity(e, m_locations[index].archetype, NULL_INDEX);
+            }
+
+            /**
+             * @brief Adds a copy of a component to every specified entity, see ComponentPool::addComponentBulk()
+             *
+             * @throw ERROR::ComponentAlreadyAttached => if an entity already has the component or shows up twice, nothing is added
+             */
+            template<ComponentType T, std::ranges::forward_range Range>
+            void addComponentBulk(const Range &entities, const T &prototype, std::size_t slot) {
+                for (EntityID e : entities) {
+                    if (hasComponent(e, slot))
+                        throw ERROR::ComponentAlreadyAttached(e, std::string(typeid(T).name()));
+                }
+                if (EntityID duplicate = duplicateEntity(entities); duplicate != NULL_ENTITY)
+                    throw ERROR::ComponentAlreadyAttached(duplicate, std::string(typeid(T).name()));
+                for (EntityID e : entities)
+                    addComponent<T>(e, slot) = prototype;
+            }
+
+            /**
+             * @brief Applies a batch of additions and removals, see ComponentPool::applyCommands()
+             */
+            template<ComponentType T>
+            void applyCommands(std::span<const ComponentCommand<T>> commands, std::size_t slot) {
+                for (const auto &it : commands) {
+                    if (it.value == nullptr)
+                        removeComponent(it.entity, slot);
+                    else if (hasComponent(it.entity, slot))
+                        getComponent<T>(it.entity, slot) = std::move(*it.value);
+                    else
+                        addComponent<T>(it.entity, slot) = std::move(*it.value);
+                }
+            }
+
+            std::size_t archetypeCount() const { return m_archetypes.size(); }
+
+            Archetype &archetypeAt(std::size_t index) { return *m_archetypes[index]; }
+
+        private:
+            struct Location {
+                uint32_t archetype = NULL_INDEX;
+                uint32_t row = 0;
+            };
+
+            struct MaskHash {
+                std::size_t operator()(const ComponentMask &mask) const {
+                    uint64_t hash = 0;
+
+                    for (uint64_t word : mask.words)
+                        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+                    return static_cast<std::size_t>(hash ^ (hash >> 32));
+                }
+            };
+
+            SignatureTable &m_signatures;
+            std::pmr::memory_resource *m_resource = std::pmr::get_default_resource();
+            std::vector<ColumnType> m_types;                            // Indexed by slot
+            std::vector<std::unique_ptr<Archetype>> m_archetypes;
+            std::unordered_map<ComponentMask, uint32_t, MaskHash> m_lookup;
+            std::vector<uint32_t> m_root_edges;                         // Slot -> archetype made of that slot only
+            std::vector<Location> m_locations;                          // Indexed by entity index
+
+            /**
+             * @brief Returns the archetype reached by adding or removing a slot, creating it if needed
+             *
+             * @param from The archetype index, NULL_INDEX for the empty signature
+             * @return uint32_t The archetype index, NULL_INDEX for the empty signature
+             */
+            uint32_t transition(uint32_t from, std::size_t slot, bool add) {
+                std::vector<uint32_t> *edges = &m_root_edges;
+
+                if (from != NULL_INDEX) {
+                    edges = add ? &m_archetypes[from]->m_add_edges : &m_archetypes[from]->m_remove_edges;
+                    if (edges->empty())
+                        edges->assign(MAX_COMPONENTS, NULL_INDEX);
+                }
+                if ((*edges)[slot] != NULL_INDEX)
+                    return (*edges)[slot];
+
+                ComponentMask mask = from != NULL_INDEX ? m_archetypes[from]->mask() : ComponentMask();
+
+                if (add)
+                    mask.set(slot);
+                else
+                    mask.reset(slot);
+                if (mask.none())
+                    return NULL_INDEX;
+
+                auto found = m_lookup.find(mask);
+                uint32_t to;
+
+                if (found != m_lookup.end()) {
+                    to = found->second;
+                } else {
+                    to = static_cast<uint32_t>(m_archetypes.size());
+                    m_archetypes.push_back(std::make_unique<Archetype>(mask, m_types, m_resource));
+                    m_lookup.emplace(mask, to);
+                }
+                (*edges)[slot] = to;
+                return to;
+            }
+
+            /**
+             * @brief Moves an entity's row between two archetypes, shared components are moved,
+             * new ones are default-constructed and dropped ones are destroyed
+             *
+             * @param from The current archetype, NULL_INDEX if the entity has no component
+             * @param to The new archetype, NULL_INDEX to drop every component
+             */
+            void moveEntity(EntityID e, uint32_t from, uint32_t to) {
+                Location &location = m_locations[entityIndex(e)];
+                Archetype *src = from != NULL_INDEX ? m_archetypes[from].get() : nullptr;
+                std::size_t src_row = location.row;
+
+                if (to != NULL_INDEX) {
+                    Archetype &dst = *m_archetypes[to];
+                    std::size_t row = dst.pushRow(e);
+
+                    for (std::size_t column = 0; column < dst.m_slots.size(); column++) {
+                        uint16_t src_column = src != nullptr ? src->columnOf(dst.m_slots[column]) : Archetype::NULL_COLUMN;
+
+                        if (src_column != Archetype::NULL_COLUMN)
+                            dst.m_types[column].relocate(dst.cell(column, row), src->cell(src_column, src_row));
+                        else
+                            dst.m_types[column].construct(dst.cell(column, row));
+                    }
+                    location = Location{to, static_cast<uint32_t>(row)};
+                } else {
+                    location = Location{};
+                }
+                if (src == nullptr)
+                    return;
+                for (std::size_t column = 0; column < src->m_slots.size(); column++) {
+                    if (to == NULL_INDEX || m_archetypes[to]->columnOf(src->m_slots[column]) == Archetype::NULL_COLUMN)
+                        src->m_types[column].destroy(src->cell(column, src_row));
+                }
+
+                EntityID moved = src->eraseRow(src_row);
+
+                if (moved != NULL_ENTITY)
+                    m_locations[entityIndex(moved)].row = static_cast<uint32_t>(src_row);
+            }
+    };
+}
+
+#endif /* !ARCHETYPE_HPP_ */
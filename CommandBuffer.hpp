@@ -0,0 +1,234 @@
+/*
+ *  CommandBuffer
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef COMMANDBUFFER_HPP_
+    #define COMMANDBUFFER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <span>
+#include <algorithm>
+
+#include "Includes.hpp"
+#include "Component.hpp"
+#include "Registry.hpp"
+
+namespace ECS {
+
+    /**
+     * @brief Type-erased list of deferred component commands of a single type
+     */
+    class IComponentCommands {
+        public:
+            virtual ~IComponentCommands() = default;
+
+            /**
+             * @brief Applies the commands of every buffer for this type, in buffer order, sorted by entity
+             *
+             * @param registry The registry holding the pool
+             * @param entities The entity table, commands on inactive entities are dropped
+             * @param lists The lists of every buffer holding commands of this type, this one included
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             */
+            virtual void apply(Registry &registry, std::span<const Entity> entities, std::span<IComponentCommands *const> lists) = 0;
+            virtual void clear() = 0;
+            virtual bool empty() const = 0;
+    };
+
+    /**
+     * @brief Deferred component commands of a single type
+     *
+     * @tparam T The component type
+     */
+    template<ComponentType T>
+    class ComponentCommands : public IComponentCommands {
+        public:
+            void add(EntityID e, T value)
+            {
+                m_commands.push_back(Command{e, static_cast<uint32_t>(m_values.size())});
+                m_values.push_back(std::move(value));
+            }
+
+            void remove(EntityID e)
+            {
+                m_commands.push_back(Command{e, NULL_INDEX});
+            }
+
+            void apply(Registry &registry, std::span<const Entity> entities, std::span<IComponentCommands *const> lists) override
+            {
+                std::vector<ComponentCommand<T>> &batch = m_batch;
+
+                batch.clear();
+                for (IComponentCommands *list : lists) {
+                    auto &typed = static_cast<ComponentCommands<T> &>(*list);
+
+                    for (const auto &it : typed.m_commands) {
+                        // Commands on entities deleted in the meantime are dropped
+                        if (!entityIsAlive(entities, it.entity))
+                            continue;
+                        batch.push_back(ComponentCommand<T>{it.entity, it.value == NULL_INDEX ? nullptr : &typed.m_values[it.value]});
+                    }
+                }
+                // Stable, so commands on the same entity keep their recording order
+                std::stable_sort(batch.begin(), batch.end(), [](const auto &a, const auto &b) { return a.entity < b.entity; });
+                registry.applyCommands<T>(batch);
+            }
+
+            void clear() override
+            {
+                m_commands.clear();
+                m_values.clear();
+                m_batch.clear();
+            }
+
+            bool empty() const override
+            {
+                return m_commands.empty();
+            }
+
+        private:
+            struct Command {
+                EntityID entity;
+                uint32_t value;                 // Index in m_values, NULL_INDEX for a removal
+            };
+
+            std::vector<Command> m_commands;
+            std::vector<T> m_values;
+            std::vector<ComponentCommand<T>> m_batch;
+    };
+
+    /**
+     * @brief Records structural changes to apply later, in one batch, see ECS::commands()
+     *
+     * A buffer is meant to be used by a single thread, the changes are applied
+     * by ECS::flushCommands(), which ECS::Update() calls once every system ran.
+     * At that point entities are created first, then components are added and removed
+     * (grouped by type and sorted by entity), then entities are deleted.
+     */
+    class CommandBuffer {
+        public:
+            CommandBuffer(ECS &world)
+            : m_world(world)
+            {}
+
+            /**
+             * @brief Reserves a new entity ID, the entity becomes active at the next flush
+             *
+             * The ID can be used right away with the other commands of any buffer.
+             * Reserving never locks: during ECS::Update() the buffer recycles the freed IDs it was handed
+             * before the systems ran, otherwise it takes a fresh index from the world's atomic cursor.
+             * Defined in ECS.hpp.
+             *
+             * @param group OPTIONAL the entity group
+             * @return EntityID The reserved ID
+             */
+            EntityID entityCreate(EntityGroup group = NONE);
+
+            /**
+             * @brief Deletes an entity at the next flush
+             *
+             * @param e EntityID
+             */
+            void entityDelete(EntityID e)
+            {
+                m_deleted.push_back(e);
+            }
+
+            /**
+             * @brief Attaches a component to an entity at the next flush, if the entity already has one it is assigned
+             *
+             * @tparam T The component type
+             * @param e EntityID
+             * @param value OPTIONAL the component value
+             */
+            template<ComponentType T>
+            void entityAddComponent(EntityID e, T value = T())
+            {
+                commandsOf<T>().add(e, std::move(value));
+            }
+
+            /**
+             * @brief Removes a component from an entity at the next flush
+             *
+             * @tparam T The component type
+             * @param e EntityID
+             */
+            template<ComponentType T>
+            void entityRemoveComponent(EntityID e)
+            {
+                commandsOf<T>().remove(e);
+            }
+
+            /**
+             * @brief Checks if the buffer holds no command
+             */
+            bool empty() const
+            {
+                if (!m_created.empty() || !m_deleted.empty())
+                    return false;
+                return std::all_of(m_types.begin(), m_types.end(), [this](uint16_t type) { return m_components[type]->empty(); });
+            }
+
+        private:
+            friend class ECS;
+
+            struct Creation {
+                EntityID entity;
+                EntityGroup group;
+            };
+
+            ECS &m_world;
+            std::vector<Creation> m_created;
+            std::vector<EntityID> m_deleted;
+            std::vector<EntityID> m_free_ids;                                   // Recycled IDs to reserve from, see ECS::fillIdCaches()
+            std::size_t m_reserved = 0;                                         // Reservations since the last flush
+            std::size_t m_reserved_last = 0;                                    // Reservations between the two previous flushes
+            std::size_t m_reserved_before = 0;                                  // Reservations in the flush interval before that
+            std::vector<std::unique_ptr<IComponentCommands>> m_components;     // Indexed by component type ID
+            std::vector<uint16_t> m_types;                                      // Type IDs with a list in m_components
+
+            template<ComponentType T>
+            ComponentCommands<T> &commandsOf()
+            {
+                uint16_t type = ComponentTypeId::get<T>();
+
+                if (type >= m_components.size())
+                    m_components.resize(type + 1);
+                if (!m_components[type]) {
+                    m_components[type] = std::make_unique<ComponentCommands<T>>();
+                    m_types.push_back(type);
+                }
+                return static_cast<ComponentCommands<T> &>(*m_components[type]);
+            }
+
+            void clear()
+            {
+                m_created.clear();
+                m_deleted.clear();
+                for (uint16_t type : m_types)
+                    m_components[type]->clear();
+            }
+    };
+}
+
+#endif /* !COMMANDBUFFER_HPP_ */
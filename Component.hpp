@@ -25,9 +25,24 @@
 
 #include "Includes.hpp"
 #include "Errors.hpp"
+#include "ThreadPool.hpp"
+#include "Profiler.hpp"
+#include "Snapshot.hpp"
 #include <vector>
+#include <memory_resource>
+#include <numeric>
+#include <concepts>
+#include <utility>
+#include <functional>
+#include <span>
+#include <ranges>
+#include <algorithm>
 #include <limits>
 #include <cstdint>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <bit>
 #include <iostream>
 
 namespace ECS {
@@ -64,16 +79,816 @@ namespace ECS {
     };
 
     /**
-     * @brief Structure for a custom sparse set
+     * @brief Storage traits of a component type, specialize it to change how pools store the type
+     * 
+     * template<>
+     * struct ECS::ComponentTraits<Position> {
+     *     static constexpr bool split_storage = true;
+     * };
+     * 
+     * Members left out of a specialization keep their default value.
+     * 
+     * @tparam T The component type
+     */
+    template<typename T>
+    struct ComponentTraits {
+        // Store components and their entity IDs in two separate arrays instead of DenseComponent<T> cells
+        static constexpr bool split_storage = false;
+
+        // Store components in fixed blocks, removals leave tombstones instead of moving the last component,
+        // so references stay valid until the component is removed or the pool is compacted
+        static constexpr bool pointer_stable = false;
+
+        // Not defined by default, see typeName()
+        // static constexpr std::string_view name = "Position";
+    };
+
+    /**
+     * @brief Returns ComponentTraits<T>::split_storage, false if the specialization doesn't define it
+     */
+    template<typename T>
+    constexpr bool isSplitStorage() {
+        if constexpr (requires { ComponentTraits<T>::split_storage; })
+            return ComponentTraits<T>::split_storage;
+        else
+            return false;
+    }
+
+    /**
+     * @brief Returns ComponentTraits<T>::pointer_stable, false if the specialization doesn't define it
+     */
+    template<typename T>
+    constexpr bool isPointerStable() {
+        if constexpr (requires { ComponentTraits<T>::pointer_stable; })
+            return ComponentTraits<T>::pointer_stable;
+        else
+            return false;
+    }
+
+    /**
+     * @brief Returns the name of a type, known at compile time and the same on every build of a given compiler
+     *
+     * Define `static constexpr std::string_view name` in the type's ComponentTraits to pin the name,
+     * e.g. to read snapshots written by another compiler or to rename the type without breaking them.
+     *
+     * @tparam T The type
+     * @return std::string_view The name, int or Game::Position
+     */
+    template<typename T>
+    constexpr auto typeName() {
+        if constexpr (requires { ComponentTraits<T>::name; }) {
+            return std::string_view(ComponentTraits<T>::name);
+        } else {
+#if defined(_MSC_VER) && !defined(__clang__)
+            // auto __cdecl ECS::typeName<struct Game::Position>(void)
+            std::string_view name = __FUNCSIG__;
+            std::size_t begin = name.find("typeName<") + 9;
+            std::size_t end = name.rfind(">(void)");
+
+            for (std::string_view prefix : {"struct ", "class ", "enum ", "union "}) {
+                if (name.substr(begin, prefix.size()) == prefix)
+                    begin += prefix.size();
+            }
+#else
+            // constexpr auto ECS::typeName() [with T = Game::Position], "[T = Game::Position]" with Clang
+            std::string_view name = __PRETTY_FUNCTION__;
+            std::size_t begin = name.find("T = ") + 4;
+            std::size_t end = name.rfind(']');
+#endif
+            return name.substr(begin, end - begin);
+        }
+    }
+
+    /**
+     * @brief Returns a hash of typeName<T>(), identifies a type in serialized data
+     *
+     * Unlike ComponentTypeId::get<T>() it doesn't depend on the order types are first used in,
+     * it only changes when the type is renamed.
+     *
+     * @tparam T The type
+     * @return uint32_t The ID
+     */
+    template<typename T>
+    constexpr uint32_t stableTypeId() {
+        return nameHash(typeName<T>());
+    }
+
+    #ifndef BLOB_ECS_STABLE_BLOCK_SIZE
+        #define BLOB_ECS_STABLE_BLOCK_SIZE 16384
+    #endif
+    // Size in bytes of the blocks of pointer-stable pools, larger if a single component doesn't fit
+    constexpr std::size_t STABLE_BLOCK_SIZE = BLOB_ECS_STABLE_BLOCK_SIZE;
+
+    /**
+     * @brief Returns the smallest amount of elements of a given size that spans whole cache lines
+     * 
+     * @param element_size The size of an element in bytes
+     * @return std::size_t Element count
+     */
+    constexpr std::size_t cacheLineElements(std::size_t element_size) {
+        return CACHE_LINE_SIZE / std::gcd(element_size, CACHE_LINE_SIZE);
+    }
+
+    /**
+     * @brief Allocates arrays on a cache line boundary from a memory resource, so that the dense ranges
+     * starting at multiples of cacheLineElements() begin on one, see ComponentPool::alignChunkSize()
+     * 
+     * @tparam T The element type
+     */
+    template<typename T>
+    class CacheAlignedAllocator {
+        public:
+            using value_type = T;
+
+            CacheAlignedAllocator(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) noexcept
+            : m_resource(resource)
+            {}
+
+            template<typename U>
+            CacheAlignedAllocator(const CacheAlignedAllocator<U> &other) noexcept
+            : m_resource(other.resource())
+            {}
+
+            T *allocate(std::size_t n) {
+                return static_cast<T *>(m_resource->allocate(n * sizeof(T), ALIGNMENT));
+            }
+
+            void deallocate(T *data, std::size_t n) noexcept {
+                m_resource->deallocate(data, n * sizeof(T), ALIGNMENT);
+            }
+
+            std::pmr::memory_resource *resource() const noexcept {
+                return m_resource;
+            }
+
+            template<typename U>
+            bool operator==(const CacheAlignedAllocator<U> &other) const noexcept {
+                return *m_resource == *other.resource();
+            }
+
+        private:
+            static constexpr std::size_t ALIGNMENT = std::max(alignof(T), CACHE_LINE_SIZE);
+
+            std::pmr::memory_resource *m_resource;
+    };
+
+    // Dense array of a pool, see CacheAlignedAllocator
+    template<typename T>
+    using CacheAlignedVector = std::vector<T, CacheAlignedAllocator<T>>;
+
+    #ifndef BLOB_ECS_SPARSE_PAGE_SIZE
+        #define BLOB_ECS_SPARSE_PAGE_SIZE 4096
+    #endif
+    // Entries per page of the pools' sparse arrays
+    constexpr std::size_t SPARSE_PAGE_SIZE = BLOB_ECS_SPARSE_PAGE_SIZE;
+    static_assert(std::has_single_bit(SPARSE_PAGE_SIZE), "BLOB_ECS_SPARSE_PAGE_SIZE must be a power of 2");
+
+    /**
+     * @brief Entity index -> dense index mapping, split in fixed-size pages allocated on demand
+     * 
+     * Missing pages point to a shared read-only page filled with NULL_INDEX, so a lookup is
+     * always the page pointer then the entry, without checking whether the page exists.
+     * A page is released once it holds no entry anymore, memory follows the real population.
+     */
+    class SparseArray {
+        public:
+            explicit SparseArray(std::pmr::memory_resource *resource)
+            : m_pages(resource), m_counts(resource), m_resource(resource)
+            {}
+
+            ~SparseArray() {
+                for (const uint32_t *page : m_pages) {
+                    if (page != s_null_page.data())
+                        m_resource->deallocate(const_cast<uint32_t *>(page), SPARSE_PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t));
+                }
+            }
+
+            SparseArray(const SparseArray &) = delete;
+            SparseArray &operator=(const SparseArray &) = delete;
+
+            /**
+             * @brief Returns the entry of an index, the index must be lower than extent()
+             */
+            uint32_t operator[](EntityIndex index) const {
+                return m_pages[index / SPARSE_PAGE_SIZE][index % SPARSE_PAGE_SIZE];
+            }
+
+            /**
+             * @brief Returns the entry of an index, NULL_INDEX if it has none
+             */
+            uint32_t get(EntityIndex index) const {
+                std::size_t page = index / SPARSE_PAGE_SIZE;
+
+                return page < m_pages.size() ? m_pages[page][index % SPARSE_PAGE_SIZE] : NULL_INDEX;
+            }
+
+            /**
+             * @brief Sets the entry of an index, its page is allocated if needed
+             * 
+             * @param index The entity index
+             * @param value The dense index, not NULL_INDEX
+             */
+            void set(EntityIndex index, uint32_t value) {
+                std::size_t page = index / SPARSE_PAGE_SIZE;
+
+                if (page >= m_pages.size())
+                    reserve(index);
+                if (m_pages[page] == s_null_page.data()) {
+                    uint32_t *fresh = static_cast<uint32_t *>(m_resource->allocate(SPARSE_PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t)));
+
+                    std::fill_n(fresh, SPARSE_PAGE_SIZE, NULL_INDEX);
+                    m_pages[page] = fresh;
+                    BLOB_ECS_COUNT(SPARSE_PAGE_ALLOCATIONS, 1);
+                }
+
+                uint32_t &entry = const_cast<uint32_t *>(m_pages[page])[index % SPARSE_PAGE_SIZE];
+
+                if (entry == NULL_INDEX)
+                    m_counts[page]++;
+                entry = value;
+            }
+
+            /**
+             * @brief Clears the entry of an index, its page is released if it was the last one
+             */
+            void reset(EntityIndex index) {
+                std::size_t page = index / SPARSE_PAGE_SIZE;
+
+                if (page >= m_pages.size() || m_pages[page][index % SPARSE_PAGE_SIZE] == NULL_INDEX)
+                    return;
+                const_cast<uint32_t *>(m_pages[page])[index % SPARSE_PAGE_SIZE] = NULL_INDEX;
+                if (--m_counts[page] == 0) {
+                    m_resource->deallocate(const_cast<uint32_t *>(m_pages[page]), SPARSE_PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t));
+                    m_pages[page] = s_null_page.data();
+                }
+            }
+
+            /**
+             * @brief Grows the page table so that it covers an index, no page is allocated
+             */
+            void reserve(EntityIndex max_index) {
+                std::size_t pages = max_index / SPARSE_PAGE_SIZE + 1;
+
+                if (pages > m_pages.size()) {
+                    BLOB_ECS_COUNT(SPARSE_TABLE_GROWTHS, 1);
+                    m_pages.resize(std::max(pages, m_pages.size() * 2), s_null_page.data());
+                    m_counts.resize(m_pages.size(), 0);
+                }
+            }
+
+            /**
+             * @brief Releases every page and the page table
+             */
+            void clear() {
+                for (const uint32_t *page : m_pages) {
+                    if (page != s_null_page.data())
+                        m_resource->deallocate(const_cast<uint32_t *>(page), SPARSE_PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t));
+                }
+                m_pages.clear();
+                m_counts.clear();
+            }
+
+            /**
+             * @brief Drops the page table past the last allocated page, pages are already released once empty
+             */
+            void shrink() {
+                std::size_t pages = m_pages.size();
+
+                while (pages != 0 && m_counts[pages - 1] == 0)
+                    pages--;
+                m_pages.resize(pages);
+                m_counts.resize(pages);
+                m_pages.shrink_to_fit();
+                m_counts.shrink_to_fit();
+            }
+
+            /**
+             * @brief Writes the allocated pages as raw blocks
+             */
+            void save(SnapshotWriter &out) const {
+                out.value<uint64_t>(m_pages.size());
+                out.value<uint64_t>(pageCount());
+                for (std::size_t page = 0; page < m_pages.size(); page++) {
+                    if (m_counts[page] == 0)
+                        continue;
+                    out.value<uint64_t>(page);
+                    out.value<uint32_t>(m_counts[page]);
+                    out.write(m_pages[page], SPARSE_PAGE_SIZE * sizeof(uint32_t));
+                }
+            }
+
+            /**
+             * @brief Replaces the content with pages written by save(), each page is copied in one go
+             * 
+             * @throw ERROR::SnapshotError => if the pages are truncated or their counts don't match their entries,
+             * the pages loaded so far are kept and released by clear()
+             */
+            void load(SnapshotReader &in) {
+                clear();
+
+                std::size_t table = static_cast<std::size_t>(in.value<uint64_t>());
+                std::size_t pages = static_cast<std::size_t>(in.value<uint64_t>());
+
+                // The table never needs more pages than there are entity indices
+                if (table > ENTITY_INDEX_MASK / SPARSE_PAGE_SIZE + 1 || pages > table)
+                    throw ERROR::SnapshotError("corrupted sparse array");
+                if (table != 0)
+                    reserve(static_cast<EntityIndex>(table * SPARSE_PAGE_SIZE - 1));
+                for (std::size_t i = 0; i < pages; i++) {
+                    std::size_t page = static_cast<std::size_t>(in.value<uint64_t>());
+                    uint32_t count = in.value<uint32_t>();
+
+                    if (page >= m_pages.size() || m_counts[page] != 0)
+                        throw ERROR::SnapshotError("corrupted sparse array");
+
+                    // Taken before allocating, so that a truncated page leaks nothing
+                    const std::byte *bytes = in.take(SPARSE_PAGE_SIZE * sizeof(uint32_t));
+                    uint32_t *fresh = static_cast<uint32_t *>(m_resource->allocate(SPARSE_PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t)));
+
+                    std::memcpy(fresh, bytes, SPARSE_PAGE_SIZE * sizeof(uint32_t));
+                    m_pages[page] = fresh;
+                    m_counts[page] = count;
+                    if (count == 0 || count != std::count_if(fresh, fresh + SPARSE_PAGE_SIZE, [](uint32_t entry) { return entry != NULL_INDEX; }))
+                        throw ERROR::SnapshotError("corrupted sparse array");
+                }
+            }
+
+            // Amount of indices covered by the page table
+            std::size_t extent() const { return m_pages.size() * SPARSE_PAGE_SIZE; }
+
+            // Amount of entries set, over every page
+            std::size_t entries() const {
+                return std::accumulate(m_counts.begin(), m_counts.end(), std::size_t(0));
+            }
+
+            // Amount of pages actually allocated
+            std::size_t pageCount() const {
+                return static_cast<std::size_t>(std::count_if(m_counts.begin(), m_counts.end(), [](uint32_t count) { return count != 0; }));
+            }
+
+        private:
+            static constexpr std::array<uint32_t, SPARSE_PAGE_SIZE> s_null_page = []() {
+                std::array<uint32_t, SPARSE_PAGE_SIZE> page{};
+
+                page.fill(NULL_INDEX);
+                return page;
+            }();
+
+            std::pmr::vector<const uint32_t *> m_pages;
+            std::pmr::vector<uint32_t> m_counts;                    // Entries in use in each page
+            std::pmr::memory_resource *m_resource;
+    };
+
+    /**
+     * @brief Structure for a custom sparse set, dense cells interleave components and entity IDs
      * 
      * @tparam T The type of the set
+     * @tparam Split Whether components and entity IDs are stored in separate arrays
+     * @tparam Stable Whether components never move, see ComponentTraits::pointer_stable
      */
-    template<ComponentType T>
+    template<ComponentType T, bool Split = isSplitStorage<T>(), bool Stable = isPointerStable<T>()>
     struct SparseSetData {
-        std::vector<DenseComponent<T>> dense_components;           // Packed components
-        std::vector<uint32_t> sparse;                           // EntityID -> dense index mapping
+        CacheAlignedVector<DenseComponent<T>> dense_components;    // Packed components
+        SparseArray sparse;                                     // EntityID -> dense index mapping
+
+        explicit SparseSetData(std::pmr::memory_resource *resource)
+        : dense_components(resource), sparse(resource)
+        {}
+
+        // Dense ranges starting at multiples of this begin on a cache line boundary
+        static constexpr std::size_t chunk_granularity = cacheLineElements(sizeof(DenseComponent<T>));
+        static constexpr bool has_tombstones = false;
+
+        std::size_t size() const { return dense_components.size(); }
+        std::size_t count() const { return dense_components.size(); }
+        std::size_t capacity() const { return dense_components.capacity(); }
+        EntityID entityAt(std::size_t i) const { return dense_components[i].entity; }
+        T &componentAt(std::size_t i) { return dense_components[i].component; }
+        void clear() { dense_components.clear(); }
+
+        // Raw copies of the dense array, T must be trivially copyable
+        void save(SnapshotWriter &out) const { out.block(std::span<const DenseComponent<T>>(dense_components)); }
+        void load(SnapshotReader &in) {
+            dense_components.resize(in.blockSize<DenseComponent<T>>());
+            in.copy(dense_components.data(), dense_components.size());
+        }
+
+        void reserve(std::size_t n) {
+            if (n > capacity())
+                BLOB_ECS_COUNT(POOL_REALLOCATIONS, 1);
+            dense_components.reserve(n);
+        }
+
+        void shrink() { dense_components.shrink_to_fit(); }
+
+        /**
+         * @brief Stores a new component, returns its dense index
+         */
+        template<typename... Args>
+        std::size_t emplace(EntityID e, Args &&...args) {
+            if (dense_components.size() == dense_components.capacity())
+                BLOB_ECS_COUNT(POOL_REALLOCATIONS, 1);
+            dense_components.emplace_back(DenseComponent<T>{T(std::forward<Args>(args)...), e});
+            return dense_components.size() - 1;
+        }
+
+        /**
+         * @brief Removes a component, the last one takes its place
+         * 
+         * @return EntityID The entity whose component moved to dense_index, NULL_ENTITY if none did
+         */
+        EntityID erase(std::size_t dense_index) {
+            EntityID moved = NULL_ENTITY;
+
+            if (dense_index != dense_components.size() - 1) {
+                dense_components[dense_index] = std::move(dense_components.back());
+                moved = dense_components[dense_index].entity;
+            }
+            dense_components.pop_back();
+            return moved;
+        }
+
+        /**
+         * @brief Exchanges two cells, the sparse array is left to the caller
+         */
+        void swap(std::size_t a, std::size_t b) {
+            std::swap(dense_components[a], dense_components[b]);
+        }
+    };
+
+    /**
+     * @brief Structure for a custom sparse set, components and entity IDs are stored in separate arrays
+     * 
+     * Loops that only touch components never pull entity IDs through the cache
+     * 
+     * @tparam T The type of the set
+     */
+    template<ComponentType T>
+    struct SparseSetData<T, true, false> {
+        CacheAlignedVector<T> dense_components;                 // Packed components
+        CacheAlignedVector<EntityID> dense_entities;            // Entity owning the component at the same index
+        SparseArray sparse;                                     // EntityID -> dense index mapping
+
+        explicit SparseSetData(std::pmr::memory_resource *resource)
+        : dense_components(resource), dense_entities(resource), sparse(resource)
+        {}
+
+        // Dense ranges starting at multiples of this begin on a cache line boundary in both arrays
+        static constexpr std::size_t chunk_granularity = std::lcm(cacheLineElements(sizeof(T)), cacheLineElements(sizeof(EntityID)));
+        static constexpr bool has_tombstones = false;
+
+        std::size_t size() const { return dense_entities.size(); }
+        std::size_t count() const { return dense_entities.size(); }
+        std::size_t capacity() const { return dense_entities.capacity(); }
+        EntityID entityAt(std::size_t i) const { return dense_entities[i]; }
+        T &componentAt(std::size_t i) { return dense_components[i]; }
+
+        void clear() {
+            dense_components.clear();
+            dense_entities.clear();
+        }
+
+        void save(SnapshotWriter &out) const {
+            out.block(std::span<const T>(dense_components));
+            out.block(std::span<const EntityID>(dense_entities));
+        }
+
+        void load(SnapshotReader &in) {
+            dense_components.resize(in.blockSize<T>());
+            in.copy(dense_components.data(), dense_components.size());
+            if (in.blockSize<EntityID>() != dense_components.size())
+                throw ERROR::SnapshotError("corrupted dense array");
+            dense_entities.resize(dense_components.size());
+            in.copy(dense_entities.data(), dense_entities.size());
+        }
+
+        void reserve(std::size_t n) {
+            if (n > capacity())
+                BLOB_ECS_COUNT(POOL_REALLOCATIONS, 1);
+            dense_components.reserve(n);
+            dense_entities.reserve(n);
+        }
+
+        void shrink() {
+            dense_components.shrink_to_fit();
+            dense_entities.shrink_to_fit();
+        }
+
+        template<typename... Args>
+        std::size_t emplace(EntityID e, Args &&...args) {
+            if (dense_entities.size() == dense_entities.capacity())
+                BLOB_ECS_COUNT(POOL_REALLOCATIONS, 1);
+            dense_components.emplace_back(std::forward<Args>(args)...);
+            dense_entities.push_back(e);
+            return dense_entities.size() - 1;
+        }
+
+        EntityID erase(std::size_t dense_index) {
+            EntityID moved = NULL_ENTITY;
+
+            if (dense_index != dense_entities.size() - 1) {
+                dense_components[dense_index] = std::move(dense_components.back());
+                dense_entities[dense_index] = dense_entities.back();
+                moved = dense_entities[dense_index];
+            }
+            dense_components.pop_back();
+            dense_entities.pop_back();
+            return moved;
+        }
+
+        void swap(std::size_t a, std::size_t b) {
+            std::swap(dense_components[a], dense_components[b]);
+            std::swap(dense_entities[a], dense_entities[b]);
+        }
+    };
+
+    /**
+     * @brief Structure for a pointer-stable sparse set, components live in fixed-size blocks and never move
+     * 
+     * Removing a component leaves a tombstone (NULL_ENTITY in dense_entities), the hole is reused
+     * by a later addition. Iteration still walks the blocks in order, skipping tombstones.
+     * compact() fills the holes, which moves components.
+     * 
+     * @tparam T The type of the set
+     * @tparam Split Ignored, entity IDs are always stored apart from the components
+     */
+    template<ComponentType T, bool Split>
+    struct SparseSetData<T, Split, true> {
+        static constexpr std::size_t BLOCK_ELEMENTS = std::max<std::size_t>(STABLE_BLOCK_SIZE / sizeof(T), 1);
+        static constexpr std::size_t BLOCK_ALIGN = std::max(alignof(T), CACHE_LINE_SIZE);
+
+        std::pmr::vector<T *> blocks;                           // Storage for BLOCK_ELEMENTS components each
+        CacheAlignedVector<EntityID> dense_entities;            // Entity owning the cell at the same index, NULL_ENTITY for a tombstone
+        std::pmr::vector<uint32_t> free_cells;                  // Tombstones to reuse, may hold stale entries
+        SparseArray sparse;                                     // EntityID -> dense index mapping
+        std::size_t live = 0;
+
+        explicit SparseSetData(std::pmr::memory_resource *resource)
+        : blocks(resource), dense_entities(resource), free_cells(resource), sparse(resource)
+        {}
+
+        ~SparseSetData() {
+            for (std::size_t i = 0; i < dense_entities.size(); i++) {
+                if (dense_entities[i] != NULL_ENTITY)
+                    componentAt(i).~T();
+            }
+            for (T *block : blocks)
+                blocks.get_allocator().resource()->deallocate(block, BLOCK_ELEMENTS * sizeof(T), BLOCK_ALIGN);
+        }
+
+        SparseSetData(const SparseSetData &) = delete;
+        SparseSetData &operator=(const SparseSetData &) = delete;
+
+        static constexpr std::size_t chunk_granularity = std::lcm(cacheLineElements(sizeof(T)), cacheLineElements(sizeof(EntityID)));
+        static constexpr bool has_tombstones = true;
+
+        // Amount of cells, tombstones included
+        std::size_t size() const { return dense_entities.size(); }
+        std::size_t count() const { return live; }
+        std::size_t capacity() const { return blocks.size() * BLOCK_ELEMENTS; }
+        EntityID entityAt(std::size_t i) const { return dense_entities[i]; }
+        T &componentAt(std::size_t i) { return *std::launder(blocks[i / BLOCK_ELEMENTS] + i % BLOCK_ELEMENTS); }
+
+        void clear() {
+            for (std::size_t i = 0; i < dense_entities.size(); i++) {
+                if (dense_entities[i] != NULL_ENTITY)
+                    componentAt(i).~T();
+            }
+            dense_entities.clear();
+            free_cells.clear();
+            live = 0;
+        }
+
+        // The cells' entities, then the live components only, tombstones carry no bytes
+        void save(SnapshotWriter &out) const {
+            out.block(std::span<const EntityID>(dense_entities));
+            for (std::size_t i = 0; i < dense_entities.size(); i++) {
+                if (dense_entities[i] != NULL_ENTITY)
+                    out.write(std::launder(blocks[i / BLOCK_ELEMENTS] + i % BLOCK_ELEMENTS), sizeof(T));
+            }
+        }
+
+        void load(SnapshotReader &in) {
+            dense_entities.resize(in.blockSize<EntityID>());
+            in.copy(dense_entities.data(), dense_entities.size());
+            reserve(dense_entities.size());
+            for (std::size_t i = 0; i < dense_entities.size(); i++) {
+                if (dense_entities[i] == NULL_ENTITY) {
+                    free_cells.push_back(static_cast<uint32_t>(i));
+                    continue;
+                }
+                in.copy(blocks[i / BLOCK_ELEMENTS] + i % BLOCK_ELEMENTS, 1);
+                live++;
+            }
+        }
+
+        void reserve(std::size_t n) {
+            while (capacity() < n) {
+                void *block = blocks.get_allocator().resource()->allocate(BLOCK_ELEMENTS * sizeof(T), BLOCK_ALIGN);
+
+                BLOB_ECS_COUNT(POOL_REALLOCATIONS, 1);
+                blocks.push_back(static_cast<T *>(block));
+            }
+            // The entity array does move, it grows geometrically like the other layouts'
+            if (n > dense_entities.capacity())
+                dense_entities.reserve(std::max(capacity(), dense_entities.capacity() * 2));
+        }
+
+        /**
+         * @brief Releases the blocks past the last cell, nothing moves, tombstones are left to compact()
+         */
+        void shrink() {
+            while (capacity() >= dense_entities.size() + BLOCK_ELEMENTS) {
+                blocks.get_allocator().resource()->deallocate(blocks.back(), BLOCK_ELEMENTS * sizeof(T), BLOCK_ALIGN);
+                blocks.pop_back();
+            }
+            blocks.shrink_to_fit();
+            dense_entities.shrink_to_fit();
+            free_cells.shrink_to_fit();
+        }
+
+        template<typename... Args>
+        std::size_t emplace(EntityID e, Args &&...args) {
+            std::size_t index = dense_entities.size();
+
+            while (!free_cells.empty()) {
+                std::size_t cell = free_cells.back();
+
+                free_cells.pop_back();
+                if (cell < dense_entities.size() && dense_entities[cell] == NULL_ENTITY) {
+                    index = cell;
+                    break;
+                }
+            }
+            if (index == dense_entities.size()) {
+                reserve(index + 1);
+                dense_entities.push_back(NULL_ENTITY);
+            }
+            new (blocks[index / BLOCK_ELEMENTS] + index % BLOCK_ELEMENTS) T(std::forward<Args>(args)...);
+            dense_entities[index] = e;
+            live++;
+            return index;
+        }
+
+        /**
+         * @brief Destroys a component and leaves a tombstone, nothing moves
+         * 
+         * @return EntityID Always NULL_ENTITY
+         */
+        EntityID erase(std::size_t dense_index) {
+            componentAt(dense_index).~T();
+            dense_entities[dense_index] = NULL_ENTITY;
+            live--;
+            // Trailing tombstones are dropped right away, the others wait for a reuse or compact()
+            while (!dense_entities.empty() && dense_entities.back() == NULL_ENTITY)
+                dense_entities.pop_back();
+            if (dense_index < dense_entities.size())
+                free_cells.push_back(static_cast<uint32_t>(dense_index));
+            return NULL_ENTITY;
+        }
+
+        /**
+         * @brief Exchanges two live cells, this moves components, see compact()
+         */
+        void swap(std::size_t a, std::size_t b) {
+            std::swap(componentAt(a), componentAt(b));
+            std::swap(dense_entities[a], dense_entities[b]);
+        }
+
+        /**
+         * @brief Moves the last components into the tombstones, then releases the unused blocks
+         * 
+         * @param moved Called with (entity, old dense index, new dense index) for every moved component
+         */
+        template<typename Func>
+        void compact(Func &&moved) {
+            std::size_t hole = 0;
+
+            while (true) {
+                while (hole < dense_entities.size() && dense_entities[hole] != NULL_ENTITY)
+                    hole++;
+                while (!dense_entities.empty() && dense_entities.back() == NULL_ENTITY)
+                    dense_entities.pop_back();
+                if (hole >= dense_entities.size())
+                    break;
+
+                std::size_t last = dense_entities.size() - 1;
+
+                new (blocks[hole / BLOCK_ELEMENTS] + hole % BLOCK_ELEMENTS) T(std::move(componentAt(last)));
+                componentAt(last).~T();
+                dense_entities[hole] = dense_entities[last];
+                dense_entities.pop_back();
+                moved(dense_entities[hole], last, hole);
+            }
+            free_cells.clear();
+            while (capacity() >= dense_entities.size() + BLOCK_ELEMENTS) {
+                blocks.get_allocator().resource()->deallocate(blocks.back(), BLOCK_ELEMENTS * sizeof(T), BLOCK_ALIGN);
+                blocks.pop_back();
+            }
+        }
+    };
+    /**
+     * @brief Finds an entity whose index shows up twice in a range, see ComponentPool::addComponentBulk()
+     * 
+     * Ranges with increasing indices, like the ones entityCreateBulk() returns, are checked in one pass,
+     * the others are sorted by index.
+     * 
+     * @param entities The entities
+     * @return EntityID The second entity with a repeated index, NULL_ENTITY if there is none
+     */
+    template<std::ranges::forward_range Range>
+    EntityID duplicateEntity(const Range &entities) {
+        EntityIndex previous = 0;
+        bool increasing = true;
+        bool first = true;
+
+        for (EntityID e : entities) {
+            if (!first && entityIndex(e) <= previous) {
+                increasing = false;
+                break;
+            }
+            previous = entityIndex(e);
+            first = false;
+        }
+        if (increasing)
+            return NULL_ENTITY;
+
+        std::vector<EntityID> sorted(std::ranges::begin(entities), std::ranges::end(entities));
+        auto byIndex = [](EntityID a, EntityID b) { return entityIndex(a) < entityIndex(b); };
+
+        std::sort(sorted.begin(), sorted.end(), byIndex);
+
+        auto it = std::adjacent_find(sorted.begin(), sorted.end(), [](EntityID a, EntityID b) { return entityIndex(a) == entityIndex(b); });
+
+        return it == sorted.end() ? NULL_ENTITY : *std::next(it);
+    }
+
+    /**
+     * @brief A deferred addition or removal of a component, see ComponentPool::applyCommands()
+     * 
+     * @tparam T The component type
+     */
+    template<typename T>
+    struct ComponentCommand {
+        EntityID entity;
+        T *value;                       // Value to attach, nullptr for a removal
+    };
+
+    /**
+     * @brief Gives the pools access to the signatures stored in an entity table
+     * 
+     * The table is the ECS's one once bound, a table owned by the SignatureTable otherwise
+     */
+    class SignatureTable {
+        public:
+            SignatureTable() : m_entities(&m_owned) {}
+
+            SignatureTable(const SignatureTable &) = delete;
+            SignatureTable &operator=(const SignatureTable &) = delete;
+
+            /**
+             * @brief Sets the entity table the signatures are stored in
+             * 
+             * @param entities The table, nullptr to use the SignatureTable's own
+             */
+            void bind(std::vector<Entity> *entities) {
+                m_entities = entities != nullptr ? entities : &m_owned;
+            }
+
+            void set(EntityIndex index, std::size_t slot) {
+                std::vector<Entity> &entities = *m_entities;
+
+                if (index >= entities.size())
+                    entities.resize(std::max<std::size_t>(index + 1, entities.size() * 2));
+                entities[index].components.set(slot);
+            }
+
+            void reset(EntityIndex index, std::size_t slot) {
+                if (index < m_entities->size())
+                    (*m_entities)[index].components.reset(slot);
+            }
+
+            /**
+             * @brief Get the signature of an entity
+             * 
+             * @param index The entity index
+             * @return ComponentMask The components the entity has, empty for unknown indices
+             */
+            ComponentMask get(EntityIndex index) const {
+                return index < m_entities->size() ? (*m_entities)[index].components : ComponentMask();
+            }
+
+            /**
+             * @brief Get the entity table holding the signatures
+             */
+            std::span<const Entity> entities() const {
+                return *m_entities;
+            }
+
+        private:
+            std::vector<Entity> *m_entities;
+            std::vector<Entity> m_owned;
     };
-    constexpr uint32_t NULL_INDEX = std::numeric_limits<uint32_t>::max();
 
     /**
      * @brief ComponentPool interface, this should be casted to a <compType>ComponentPool to be used
@@ -82,6 +897,76 @@ namespace ECS {
         public:
             virtual ~IComponentPool() = default;
             virtual void disableEntity(EntityID) = 0;
+            virtual void syncCache() = 0;
+
+            /**
+             * @brief Makes the pool keep a signature table up to date
+             * 
+             * @param signatures The table, nullptr to stop
+             * @param slot The bit standing for this pool in the signatures
+             */
+            void setSignatureSlot(SignatureTable *signatures, std::size_t slot) {
+                m_signatures = signatures;
+                m_slot = slot;
+            }
+
+            /**
+             * @brief Makes the pool stamp additions, writes and removals with a tick, see Registry::changeTick()
+             * 
+             * @param tick The current tick, read on every stamp, nullptr to stamp 0
+             */
+            void setTickSource(const uint32_t *tick) {
+                m_tick = tick;
+            }
+
+            /**
+             * @brief Forgets the removals stamped at or before a tick
+             * 
+             * @param tick Every reader has seen the removals up to this tick
+             */
+            virtual void trimRemoved(uint32_t tick) = 0;
+
+            /**
+             * @brief Releases the storage the pool doesn't use, see ComponentPool::shrink()
+             * 
+             * @param utilization The dense storage is shrunk once less than this fraction of it is in use
+             */
+            virtual void shrink(float utilization) = 0;
+
+            /**
+             * @brief Writes the pool's dense and sparse arrays as raw blocks, see ECS::saveSnapshot()
+             * 
+             * @throw ERROR::SnapshotError => if the component type isn't trivially copyable
+             */
+            virtual void saveSnapshot(SnapshotWriter &out) const = 0;
+
+            /**
+             * @brief Replaces the pool's content with blocks written by saveSnapshot()
+             * 
+             * @throw ERROR::SnapshotError => if the blocks were written by a pool of another type or layout
+             */
+            virtual void loadSnapshot(SnapshotReader &in) = 0;
+
+            /**
+             * @brief Writes the components written after a tick and the removals since, see ECS::writeDelta()
+             */
+            virtual void writeDelta(SnapshotWriter &out, uint32_t since) = 0;
+
+            /**
+             * @brief Applies what writeDelta() wrote, removals first then the written components in one batch
+             * 
+             * @throw ERROR::SnapshotError => if the delta was written by a pool of another type
+             */
+            virtual void applyDelta(SnapshotReader &in) = 0;
+
+        protected:
+            SignatureTable *m_signatures = nullptr;
+            std::size_t m_slot = 0;
+            const uint32_t *m_tick = nullptr;
+
+            uint32_t currentTick() const {
+                return m_tick != nullptr ? *m_tick : 0;
+            }
     };
 
     /**
@@ -92,9 +977,20 @@ namespace ECS {
     template <ComponentType T>
     class ComponentPool : public IComponentPool {
         public:
-            ComponentPool() : m_cache_dirty(true) {
-                m_data.dense_components.reserve(10000);
-                m_data.sparse.reserve(100000);
+            // Removals leave tombstones (NULL_ENTITY cells) that iterations must skip
+            static constexpr bool has_tombstones = SparseSetData<T>::has_tombstones;
+
+            /**
+             * @brief Construct a new ComponentPool object, nothing is allocated without a capacity hint
+             * 
+             * @param capacity_hint OPTIONAL amount of components to reserve room for
+             * @param resource OPTIONAL the memory resource the dense and sparse arrays allocate from
+             */
+            ComponentPool(std::size_t capacity_hint = 0, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_data(resource), m_added_ticks(resource), m_changed_ticks(resource)
+            {
+                if (capacity_hint != 0)
+                    m_data.reserve(capacity_hint);
             }
 
             ~ComponentPool() {
@@ -108,7 +1004,22 @@ namespace ECS {
              * @return false The entity does not have the component
              */
             bool hasComponent(EntityID e) {
-                return e < m_data.sparse.size() && m_data.sparse[e] != NULL_INDEX;
+                uint32_t dense_index = m_data.sparse.get(entityIndex(e));
+
+                return dense_index != NULL_INDEX && m_data.entityAt(dense_index) == e;
+            }
+
+            /**
+             * @brief Checks if the entity occupying an index has the component, without checking its generation
+             * 
+             * This only reads the sparse array, use it when the handle is known to be alive
+             * 
+             * @param index The entity index, see entityIndex()
+             * @return true The entity has the component
+             * @return false The entity does not have the component
+             */
+            bool hasIndex(EntityIndex index) {
+                return m_data.sparse.get(index) != NULL_INDEX;
             }
 
             /**
@@ -116,23 +1027,66 @@ namespace ECS {
              * 
              * @param e The entity ID
              * @return T& Reference to the newly created component
+             * @throw ERROR::ComponentAlreadyAttached => if the entity already has the component
+             * @throw ERROR::InvalidEntityID => if another generation of the entity's index has it, the handle is stale
              */
             T &addComponent(EntityID e) {
-                if (hasComponent(e))
-                    throw ERROR::ComponentAlreadyAttached(e, std::string(typeid(T).name()));
+                EntityIndex index = entityIndex(e);
+
+                checkVacant(e);
+                uint32_t new_dense_index = static_cast<uint32_t>(m_data.emplace(e));
+                T &component = m_data.componentAt(new_dense_index);
 
-                if (e >= m_data.sparse.size())
-                    sparseGrow(e);
+                stampAdded(new_dense_index);
+                m_data.sparse.set(index, new_dense_index);
+                if (m_signatures != nullptr)
+                    m_signatures->set(index, m_slot);
+
+                if (!m_cache_rebuild)
+                    m_pending_added.push_back(e);
+                updateCacheMode();
+                return component;
+            }
 
-                uint32_t new_dense_index = static_cast<uint32_t>(m_data.dense_components.size());
-                m_data.dense_components.emplace_back();
+            /**
+             * @brief Adds a copy of a component to every specified entity, the sparse array and
+             * the dense array grow at most once and the dense array is filled in a single pass
+             * 
+             * @tparam Range A forward range of EntityID, e.g. std::span<const EntityID> or an EntityRange
+             * @param entities The entities, none of them may already have the component
+             * @param prototype The value every new component is copied from
+             * @throw ERROR::ComponentAlreadyAttached => if an entity already has the component or shows up twice, nothing is added
+             * @throw ERROR::InvalidEntityID => if another generation of an entity's index has the component, nothing is added
+             */
+            template<std::ranges::forward_range Range>
+            void addComponentBulk(const Range &entities, const T &prototype = T()) {
+                EntityIndex max_index = 0;
+                std::size_t count = 0;
 
-                m_data.dense_components[new_dense_index].entity = e;
+                for (EntityID e : entities) {
+                    checkVacant(e);
+                    max_index = std::max(max_index, entityIndex(e));
+                    count++;
+                }
+                if (count == 0)
+                    return;
+                if (EntityID duplicate = duplicateEntity(entities); duplicate != NULL_ENTITY)
+                    throw ERROR::ComponentAlreadyAttached(duplicate, std::string(typeid(T).name()));
+                m_data.sparse.reserve(max_index);
+                reserveFor(count);
 
-                m_data.sparse[e] = new_dense_index;
+                for (EntityID e : entities) {
+                    EntityIndex index = entityIndex(e);
+                    uint32_t dense_index = static_cast<uint32_t>(m_data.emplace(e, prototype));
 
-                m_cache_dirty = true;
-                return m_data.dense_components.back().component;
+                    stampAdded(dense_index);
+                    m_data.sparse.set(index, dense_index);
+                    if (m_signatures != nullptr)
+                        m_signatures->set(index, m_slot);
+                    if (!m_cache_rebuild)
+                        m_pending_added.push_back(e);
+                    updateCacheMode();
+                }
             }
 
             /**
@@ -143,21 +1097,59 @@ namespace ECS {
             void removeComponent(EntityID e) {
                 if (!hasComponent(e)) return;
 
-                uint32_t dense_index = m_data.sparse[e];
-                uint32_t last_index = static_cast<uint32_t>(m_data.dense_components.size() - 1);
+                uint32_t dense_index = m_data.sparse[entityIndex(e)];
+                EntityID moved_entity = m_data.erase(dense_index);
 
-                if (dense_index != last_index) {
-                    m_data.dense_components[dense_index] = std::move(m_data.dense_components[last_index]);
-                    
-                    EntityID moved_entity = m_data.dense_components[dense_index].entity;
-                    m_data.sparse[moved_entity] = dense_index;
+                if (moved_entity != NULL_ENTITY) {
+                    m_data.sparse.set(entityIndex(moved_entity), dense_index);
+                    // The moved component came from the old last cell
+                    m_added_ticks[dense_index] = m_added_ticks[m_data.size()];
+                    m_changed_ticks[dense_index] = m_changed_ticks[m_data.size()];
                 }
+                m_added_ticks.resize(m_data.size());
+                m_changed_ticks.resize(m_data.size());
+                m_removed_entities.push_back(e);
+                m_removed_ticks.push_back(currentTick());
+
+                m_data.sparse.reset(entityIndex(e));
+                if (m_signatures != nullptr)
+                    m_signatures->reset(entityIndex(e), m_slot);
 
-                m_data.dense_components.pop_back();
+                if (!m_cache_rebuild)
+                    m_pending_removed.push_back(e);
+                updateCacheMode();
+            }
 
-                m_data.sparse[e] = NULL_INDEX;
+            /**
+             * @brief Applies a batch of additions and removals, the sparse array and the dense
+             * array grow at most once for the whole batch
+             * 
+             * Adding a component an entity already has assigns the value, removing a missing component does nothing.
+             * 
+             * @param commands The commands, in the order they should apply
+             */
+            void applyCommands(std::span<const ComponentCommand<T>> commands) {
+                EntityIndex max_index = 0;
+                std::size_t additions = 0;
 
-                m_cache_dirty = true;
+                for (const auto &it : commands) {
+                    if (it.value != nullptr) {
+                        max_index = std::max(max_index, entityIndex(it.entity));
+                        additions++;
+                    }
+                }
+                if (additions != 0) {
+                    m_data.sparse.reserve(max_index);
+                    reserveFor(additions);
+                }
+                for (const auto &it : commands) {
+                    if (it.value == nullptr)
+                        removeComponent(it.entity);
+                    else if (hasComponent(it.entity))
+                        markChanged(it.entity) = std::move(*it.value);
+                    else
+                        addComponent(it.entity) = std::move(*it.value);
+                }
             }
 
             /**
@@ -168,20 +1160,465 @@ namespace ECS {
              */
             T &getComponent(EntityID e) {
                 
-                return m_data.dense_components[m_data.sparse[e]].component;
+                return m_data.componentAt(m_data.sparse[entityIndex(e)]);
+            }
+
+            /**
+             * @brief Stamps the component of an entity as written at the current tick, see Changed<T>
+             * 
+             * @param e The entity ID, it must have the component
+             * @return T& Reference to the component
+             */
+            T &markChanged(EntityID e) {
+                uint32_t dense_index = m_data.sparse[entityIndex(e)];
+
+                m_changed_ticks[dense_index] = currentTick();
+                return m_data.componentAt(dense_index);
+            }
+
+            /**
+             * @brief Get the dense index of the component of an entity
+             * 
+             * @param e The entity ID, it must have the component
+             * @return std::size_t The index, see entityAt() / componentAt()
+             */
+            std::size_t denseIndexOf(EntityID e) const {
+                return m_data.sparse[entityIndex(e)];
+            }
+
+            /**
+             * @brief Get the tick the component at a dense index was added at
+             * 
+             * @param dense_index Index within the dense array, must be lower than size()
+             * @return uint32_t The tick
+             */
+            uint32_t addedTick(std::size_t dense_index) const {
+                return m_added_ticks[dense_index];
+            }
+
+            /**
+             * @brief Get the tick the component at a dense index was last written at, an addition counts as a write
+             * 
+             * @param dense_index Index within the dense array, must be lower than size()
+             * @return uint32_t The tick
+             */
+            uint32_t changedTick(std::size_t dense_index) const {
+                return m_changed_ticks[dense_index];
+            }
+
+            /**
+             * @brief Get the entities whose component was removed after a tick, oldest first
+             * 
+             * Entities destroyed since are listed too, an entity can appear more than once.
+             * The list is trimmed at the end of ECS::Update(), once every system has seen it.
+             * 
+             * @param tick The reference tick
+             * @return std::span<const EntityID> The entities
+             */
+            std::span<const EntityID> removedSince(uint32_t tick) const {
+                auto first = std::partition_point(m_removed_ticks.begin(), m_removed_ticks.end(),
+                    [tick](uint32_t removed) { return !tickIsNewer(removed, tick); });
+
+                return std::span<const EntityID>(m_removed_entities).subspan(first - m_removed_ticks.begin());
+            }
+
+            void trimRemoved(uint32_t tick) override {
+                auto first = std::partition_point(m_removed_ticks.begin(), m_removed_ticks.end(),
+                    [tick](uint32_t removed) { return !tickIsNewer(removed, tick); });
+                std::size_t count = first - m_removed_ticks.begin();
+
+                m_removed_entities.erase(m_removed_entities.begin(), m_removed_entities.begin() + count);
+                m_removed_ticks.erase(m_removed_ticks.begin(), m_removed_ticks.begin() + count);
+            }
+
+            /**
+             * @brief Releases the storage the pool doesn't use
+             *
+             * The sparse page table is always trimmed past the last allocated page. The dense storage,
+             * its ticks and caches are shrunk to fit once less than a fraction of it is in use, this moves
+             * the components of pools that aren't pointer-stable. Pointer-stable pools only release their
+             * trailing blocks, call compact() first to reclaim their tombstones.
+             *
+             * @param utilization The fraction of the capacity under which the dense storage is shrunk, 1 = always
+             */
+            void shrink(float utilization) override {
+                m_data.sparse.shrink();
+                if (static_cast<float>(m_data.count()) >= static_cast<float>(m_data.capacity()) * utilization)
+                    return;
+                m_data.shrink();
+                m_added_ticks.shrink_to_fit();
+                m_changed_ticks.shrink_to_fit();
+                m_cached_entities.shrink_to_fit();
+                m_pending_added.shrink_to_fit();
+                m_pending_removed.shrink_to_fit();
+                m_removed_entities.shrink_to_fit();
+                m_removed_ticks.shrink_to_fit();
+            }
+
+            void saveSnapshot(SnapshotWriter &out) const override {
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    out.string(typeName<T>());
+                    out.value<uint32_t>(sizeof(T));
+                    out.value<uint8_t>(layoutId());
+                    m_data.save(out);
+                    m_data.sparse.save(out);
+                } else {
+                    throw ERROR::SnapshotError(std::string("component '") + typeid(T).name() + "' is not trivially copyable");
+                }
+            }
+
+            void loadSnapshot(SnapshotReader &in) override {
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    if (in.string() != typeName<T>() || in.value<uint32_t>() != sizeof(T) || in.value<uint8_t>() != layoutId())
+                        throw ERROR::SnapshotError(std::string("the pool of '") + typeid(T).name() + "' doesn't match");
+                    m_data.clear();
+                    try {
+                        m_data.load(in);
+                        m_data.sparse.load(in);
+                        checkMapping();
+                        checkSignatures();
+                    } catch (...) {
+                        // An empty pool rather than entries pointing past the dense array
+                        m_data.clear();
+                        m_data.sparse.clear();
+                        throw;
+                    }
+
+                    // Everything counts as added now, nothing as removed
+                    m_added_ticks.assign(m_data.size(), currentTick());
+                    m_changed_ticks.assign(m_data.size(), currentTick());
+                    m_removed_entities.clear();
+                    m_removed_ticks.clear();
+                    m_cached_entities.clear();
+                    m_pending_added.clear();
+                    m_pending_removed.clear();
+                    m_cache_rebuild = true;
+                } else {
+                    throw ERROR::SnapshotError(std::string("component '") + typeid(T).name() + "' is not trivially copyable");
+                }
+            }
+
+            void writeDelta(SnapshotWriter &out, uint32_t since) override {
+                constexpr std::size_t record = sizeof(EntityID) + sizeof(T);
+
+                out.value<uint32_t>(stableTypeId<T>());
+                out.value<uint32_t>(sizeof(T));
+                out.value<uint8_t>(std::is_trivially_copyable_v<T>);
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    std::size_t count = 0;
+
+                    for (std::size_t i = 0; i < m_data.size(); i++)
+                        count += m_data.entityAt(i) != NULL_ENTITY && tickIsNewer(m_changed_ticks[i], since);
+                    out.value<uint64_t>(count);
+                    for (std::size_t i = 0; i < m_data.size() && count != 0; i++) {
+                        if (m_data.entityAt(i) == NULL_ENTITY || !tickIsNewer(m_changed_ticks[i], since))
+                            continue;
+
+                        std::byte bytes[record];
+                        EntityID e = m_data.entityAt(i);
+
+                        std::memcpy(bytes, &e, sizeof(EntityID));
+                        std::memcpy(bytes + sizeof(EntityID), &m_data.componentAt(i), sizeof(T));
+                        out.write(bytes, record);
+                        count--;
+                    }
+                    out.block(removedSince(since));
+                }
+            }
+
+            void applyDelta(SnapshotReader &in) override {
+                constexpr std::size_t record = sizeof(EntityID) + sizeof(T);
+
+                if (in.value<uint32_t>() != stableTypeId<T>() || in.value<uint32_t>() != sizeof(T))
+                    throw ERROR::SnapshotError(std::string("the delta of '") + typeid(T).name() + "' doesn't match");
+                // Components that can't be copied as bytes aren't replicated
+                if (in.value<uint8_t>() == 0)
+                    return;
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    std::size_t count = in.blockSize(record);
+                    const std::byte *records = in.take(count * record);
+                    std::size_t removed = in.blockSize<EntityID>();
+                    const std::byte *removals = in.take(removed * sizeof(EntityID));
+                    EntityIndex max_index = 0;
+                    std::size_t additions = 0;
+
+                    for (std::size_t i = 0; i < removed; i++) {
+                        EntityID e;
+
+                        std::memcpy(&e, removals + i * sizeof(EntityID), sizeof(EntityID));
+                        removeComponent(e);
+                    }
+                    for (std::size_t i = 0; i < count; i++) {
+                        EntityID e;
+
+                        std::memcpy(&e, records + i * record, sizeof(EntityID));
+                        max_index = std::max(max_index, entityIndex(e));
+                        additions += !hasComponent(e);
+                    }
+                    if (additions != 0) {
+                        m_data.sparse.reserve(max_index);
+                        reserveFor(additions);
+                    }
+                    for (std::size_t i = 0; i < count; i++) {
+                        EntityID e;
+
+                        std::memcpy(&e, records + i * record, sizeof(EntityID));
+                        T &component = hasComponent(e) ? markChanged(e) : addComponent(e);
+
+                        std::memcpy(static_cast<void *>(&component), records + i * record + sizeof(EntityID), sizeof(T));
+                    }
+                } else {
+                    throw ERROR::SnapshotError(std::string("component '") + typeid(T).name() + "' is not trivially copyable");
+                }
+            }
+
+            /**
+             * @brief Returns the size of the dense array, tombstones of pointer-stable pools included
+             * 
+             * @return std::size_t The dense array size, see count() for the amount of components
+             */
+            std::size_t size() const {
+                return m_data.size();
+            }
+
+            /**
+             * @brief Returns the amount of cells the dense storage holds without growing, see shrink()
+             */
+            std::size_t capacity() const {
+                return m_data.capacity();
+            }
+
+            /**
+             * @brief Returns the amount of entity indices the sparse page table covers, see shrink()
+             */
+            std::size_t sparseExtent() const {
+                return m_data.sparse.extent();
+            }
+
+            /**
+             * @brief Returns the amount of components stored in the pool
+             * 
+             * @return std::size_t Component count
+             */
+            std::size_t count() const {
+                return m_data.count();
+            }
+
+            /**
+             * @brief Get the entity stored at a dense index
+             * 
+             * @param dense_index Index within the dense array, must be lower than size()
+             * @return EntityID The entity owning that cell, NULL_ENTITY for a tombstone
+             */
+            EntityID entityAt(std::size_t dense_index) const {
+                return m_data.entityAt(dense_index);
+            }
+
+            /**
+             * @brief Get the component stored at a dense index
+             * 
+             * @param dense_index Index within the dense array, must be lower than size()
+             * @return T& Reference to the component
+             */
+            T &componentAt(std::size_t dense_index) {
+                return m_data.componentAt(dense_index);
+            }
+
+            /**
+             * @brief Contiguous view of the components, only available with ComponentTraits<T>::split_storage
+             * and without ComponentTraits<T>::pointer_stable
+             * 
+             * @return std::span<T> The components, in dense order
+             */
+            std::span<T> components() requires (isSplitStorage<T>() && !isPointerStable<T>()) {
+                return m_data.dense_components;
+            }
+
+            /**
+             * @brief Contiguous view of the entities, only available with ComponentTraits<T>::split_storage
+             * or ComponentTraits<T>::pointer_stable
+             * 
+             * @return std::span<const EntityID> The entities, in the same order as components() (holding NULL_ENTITY for tombstones)
+             */
+            std::span<const EntityID> entities() const requires (isSplitStorage<T>() || isPointerStable<T>()) {
+                return m_data.dense_entities;
+            }
+
+            /**
+             * @brief Calls fn(EntityID, T&) for each component of the pool, chunks of the dense array run in parallel
+             * 
+             * fn must be safe to call concurrently on different entities. Adding or removing components
+             * of this type until it returns is undefined behaviour.
+             * 
+             * @tparam Func The callable type
+             * @param fn The callable
+             * @param chunk_size OPTIONAL components per task, rounded up to whole cache lines, 0 = ThreadPool::DEFAULT_CHUNK_SIZE
+             * @param pool OPTIONAL the pool to run the chunks on
+             */
+            template<typename Func>
+            void parallelForEach(Func &&fn, std::size_t chunk_size = 0, ThreadPool &pool = ThreadPool::shared()) {
+                pool.parallelFor(m_data.size(), alignChunkSize(chunk_size), [this, &fn](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        if constexpr (SparseSetData<T>::has_tombstones) {
+                            if (m_data.entityAt(i) == NULL_ENTITY)
+                                continue;
+                        }
+                        std::invoke(fn, m_data.entityAt(i), m_data.componentAt(i));
+                    }
+                });
+            }
+
+            /**
+             * @brief Fills the tombstones of a pointer-stable pool and releases its unused blocks,
+             * this moves components so references to them are invalidated. Does nothing for other pools.
+             */
+            void compact() {
+                if constexpr (SparseSetData<T>::has_tombstones) {
+                    m_data.compact([this](EntityID e, std::size_t from, std::size_t to) {
+                        m_data.sparse.set(entityIndex(e), static_cast<uint32_t>(to));
+                        m_added_ticks[to] = m_added_ticks[from];
+                        m_changed_ticks[to] = m_changed_ticks[from];
+                    });
+                    m_added_ticks.resize(m_data.size());
+                    m_changed_ticks.resize(m_data.size());
+                }
+            }
+
+            /**
+             * @brief Reorders the dense array, e.g. spatially, so that iterating the pool walks memory in that order
+             * 
+             * Pointer-stable pools are compacted first. Every reference to the components is invalidated,
+             * the entity IDs, the ticks and the sorted entity cache stay valid.
+             * 
+             * @tparam Compare bool(const T&, const T&) or bool(EntityID, EntityID), a strict weak ordering
+             * @param comp The comparator
+             */
+            template<typename Compare>
+            void sortBy(Compare comp) {
+                compact();
+
+                std::vector<uint32_t> order(m_data.size());
+
+                std::iota(order.begin(), order.end(), 0);
+                if constexpr (std::predicate<Compare &, const T &, const T &>)
+                    std::sort(order.begin(), order.end(), [this, &comp](uint32_t a, uint32_t b) { return comp(std::as_const(m_data.componentAt(a)), std::as_const(m_data.componentAt(b))); });
+                else
+                    std::sort(order.begin(), order.end(), [this, &comp](uint32_t a, uint32_t b) { return comp(m_data.entityAt(a), m_data.entityAt(b)); });
+                // Walks each cycle of the permutation, cell j receives the component at order[j]
+                for (std::size_t i = 0; i < order.size(); i++) {
+                    std::size_t j = i;
+
+                    while (order[j] != i) {
+                        std::size_t next = order[j];
+
+                        swapCells(j, next);
+                        order[j] = static_cast<uint32_t>(j);
+                        j = next;
+                    }
+                    order[j] = static_cast<uint32_t>(j);
+                }
+                m_align_lead = nullptr;
+            }
+
+            /**
+             * @brief Moves the components of some entities to the front of the dense array, in the given order
+             *
+             * Pointer-stable pools are compacted first. Every reference to the components is invalidated,
+             * the entity IDs, the ticks and the sorted entity cache stay valid.
+             *
+             * @param order The entities, each listed once, those without the component are skipped
+             */
+            void arrange(std::span<const EntityID> order) {
+                std::size_t pos = 0;
+
+                compact();
+                for (EntityID e : order) {
+                    if (!hasComponent(e))
+                        continue;
+
+                    std::size_t dense_index = m_data.sparse[entityIndex(e)];
+
+                    // Cells before the position hold the entities already placed
+                    if (dense_index != pos)
+                        swapCells(pos, dense_index);
+                    pos++;
+                }
+                m_align_lead = nullptr;
+            }
+
+            /**
+             * @brief Moves the components of the entities a lead pool holds to the front of the dense array,
+             * in the lead's dense order. A view led by that pool then reads this one sequentially.
+             * 
+             * The work can be spread over several frames: each call resumes where the previous one stopped.
+             * Changes made between the calls only make the result less ordered, never wrong.
+             * Pointer-stable pools are compacted when a pass starts, references to the components are invalidated.
+             * 
+             * @tparam Lead The lead's component type
+             * @param lead The pool to follow
+             * @param budget OPTIONAL lead cells to visit during this call, 0 = the whole pool
+             * @return true If the pass is complete, the next call starts a new one
+             * @return false If the budget ran out first
+             */
+            template<ComponentType Lead>
+            bool alignTo(const ComponentPool<Lead> &lead, std::size_t budget = 0) {
+                if (m_align_lead != &lead || budget == 0) {
+                    compact();
+                    m_align_lead = &lead;
+                    m_align_cursor = 0;
+                    m_align_pos = 0;
+                }
+                for (std::size_t visited = 0; m_align_cursor < lead.size() && m_align_pos < m_data.size(); m_align_cursor++) {
+                    if (budget != 0 && visited++ == budget)
+                        return false;
+
+                    EntityID e = lead.entityAt(m_align_cursor);
+
+                    if (e == NULL_ENTITY || !hasComponent(e))
+                        continue;
+
+                    std::size_t dense_index = m_data.sparse[entityIndex(e)];
+
+                    // Cells before the position are already in place, or a tombstone left since the pass started
+                    if (dense_index < m_align_pos)
+                        continue;
+                    if constexpr (SparseSetData<T>::has_tombstones) {
+                        while (m_align_pos < dense_index && m_data.entityAt(m_align_pos) == NULL_ENTITY)
+                            m_align_pos++;
+                    }
+                    if (dense_index != m_align_pos)
+                        swapCells(m_align_pos, dense_index);
+                    m_align_pos++;
+                }
+                m_align_lead = nullptr;
+                return true;
+            }
+
+            /**
+             * @brief Rounds a chunk size up to a multiple of whole cache lines of the dense storage
+             * 
+             * @param chunk_size The requested size, 0 = ThreadPool::DEFAULT_CHUNK_SIZE
+             * @return std::size_t The aligned size
+             */
+            static std::size_t alignChunkSize(std::size_t chunk_size) {
+                constexpr std::size_t granularity = SparseSetData<T>::chunk_granularity;
+
+                if (chunk_size == 0)
+                    chunk_size = ThreadPool::DEFAULT_CHUNK_SIZE;
+                return (chunk_size + granularity - 1) / granularity * granularity;
             }
 
             /**
-             * @brief Get a vector containing every entity's id which have this component attached
+             * @brief Get a sorted vector containing every entity's id which have this component attached
+             * 
+             * The vector is updated incrementally from the changes made since the last call:
+             * removals are found by binary search and erased in one shifting pass, additions are sorted and merged in.
              * 
              * @return const std::vector<EntityID>& Vector of entities
              */
             const std::vector<EntityID> &getActiveEntities() {
-                if (m_cache_dirty) {
-                    m_cached_entities = m_data.dense_components;
-                    std::sort(m_cached_entities.begin(), m_cached_entities.end());
-                    m_cache_dirty = false;
-                }
+                if (m_cache_rebuild || !m_pending_removed.empty() || !m_pending_added.empty())
+                    applyPendingChanges();
                 return m_cached_entities;
             }
 
@@ -194,6 +1631,13 @@ namespace ECS {
                 removeComponent(e);
             }
 
+            /**
+             * @brief Brings the sorted entity cache up to date, getActiveEntities() is then read-only until the next change
+             */
+            void syncCache() override {
+                getActiveEntities();
+            }
+
             /**
              * @brief Get the Pool object
              * 
@@ -205,16 +1649,200 @@ namespace ECS {
 
         private:
             SparseSetData<T> m_data;
-            std::vector<EntityID> m_cached_entities;
-            bool m_cache_dirty;
+            std::vector<EntityID> m_cached_entities;            // Sorted entities, as of the last getActiveEntities()
+            std::vector<EntityID> m_pending_added;              // Entities added since the last sync, may hold stale entries
+            std::vector<EntityID> m_pending_removed;            // Entities removed since the last sync, may hold stale entries
+            bool m_cache_rebuild = true;                        // Too many changes, the next sync rebuilds from scratch
+            std::pmr::vector<uint32_t> m_added_ticks;           // Tick of the addition, parallel to the dense array
+            std::pmr::vector<uint32_t> m_changed_ticks;         // Tick of the last write, parallel to the dense array
+            std::vector<EntityID> m_removed_entities;           // Removals not seen by every system yet
+            std::vector<uint32_t> m_removed_ticks;              // Tick of each removal, non-decreasing
 
-            void sparseGrow(EntityID new_standard) {
-                std::size_t curr_size = m_data.sparse.size();
-                if (curr_size == 0)
-                    curr_size = 8192;
-                else
-                    while (curr_size <= new_standard) curr_size <<= 1;
-                m_data.sparse.resize(curr_size, NULL_INDEX);
+            const void *m_align_lead = nullptr;                 // Pool of the pass in progress, see alignTo()
+            std::size_t m_align_cursor = 0;                     // Next lead cell to visit
+            std::size_t m_align_pos = 0;                        // Next cell to fill
+
+            static constexpr uint8_t layoutId() {
+                return static_cast<uint8_t>(isSplitStorage<T>()) | static_cast<uint8_t>(isPointerStable<T>()) << 1;
+            }
+
+            /**
+             * @brief Makes room for some additions, blocks never move so stable pools don't grow geometrically
+             */
+            void reserveFor(std::size_t additions) {
+                std::size_t needed = m_data.size() + additions;
+
+                if (needed > m_data.capacity())
+                    m_data.reserve(SparseSetData<T>::has_tombstones ? needed : std::max(needed, m_data.capacity() * 2));
+                m_added_ticks.reserve(m_data.capacity());
+                m_changed_ticks.reserve(m_data.capacity());
+            }
+
+            /**
+             * @brief Exchanges two cells and their ticks, patching the sparse array
+             */
+            void swapCells(std::size_t a, std::size_t b) {
+                m_data.swap(a, b);
+                m_data.sparse.set(entityIndex(m_data.entityAt(a)), static_cast<uint32_t>(a));
+                m_data.sparse.set(entityIndex(m_data.entityAt(b)), static_cast<uint32_t>(b));
+                std::swap(m_added_ticks[a], m_added_ticks[b]);
+                std::swap(m_changed_ticks[a], m_changed_ticks[b]);
+            }
+
+            /**
+             * @brief Checks that the sparse array and the dense array of a loaded pool map one to one
+             * 
+             * @throw ERROR::SnapshotError => if a cell's entity doesn't map back to it, or the sparse array has other entries
+             */
+            void checkMapping() const {
+                std::size_t mapped = 0;
+
+                for (std::size_t i = 0; i < m_data.size(); i++) {
+                    EntityID e = m_data.entityAt(i);
+
+                    // Tombstones of pointer-stable pools
+                    if (e == NULL_ENTITY)
+                        continue;
+                    if (m_data.sparse.get(entityIndex(e)) != i)
+                        throw ERROR::SnapshotError("corrupted sparse array");
+                    mapped++;
+                }
+                if (mapped != m_data.sparse.entries())
+                    throw ERROR::SnapshotError("corrupted sparse array");
+            }
+
+            /**
+             * @brief Throws unless the pool holds exactly the active entities whose signature has its slot, see loadSnapshot()
+             */
+            void checkSignatures() const {
+                if (m_signatures == nullptr)
+                    return;
+
+                std::span<const Entity> entities = m_signatures->entities();
+                std::size_t mapped = 0;
+                std::size_t signed_entities = 0;
+
+                for (std::size_t i = 0; i < m_data.size(); i++) {
+                    EntityID e = m_data.entityAt(i);
+
+                    if (e == NULL_ENTITY)
+                        continue;
+                    if (!entityIsAlive(entities, e) || !entities[entityIndex(e)].components.test(m_slot))
+                        throw ERROR::SnapshotError("component of an entity without it");
+                    mapped++;
+                }
+                for (const Entity &slot : entities)
+                    signed_entities += slot.isActive && slot.components.test(m_slot);
+                if (mapped != signed_entities)
+                    throw ERROR::SnapshotError("entity signature without its component");
+            }
+
+            /**
+             * @brief Throws unless the index of an entity has no component in the pool
+             * 
+             * @throw ERROR::ComponentAlreadyAttached => if the entity has the component
+             * @throw ERROR::InvalidEntityID => if another generation of the index has it, the handle is stale
+             */
+            void checkVacant(EntityID e) {
+                uint32_t dense_index = m_data.sparse.get(entityIndex(e));
+
+                if (dense_index == NULL_INDEX)
+                    return;
+                if (m_data.entityAt(dense_index) == e)
+                    throw ERROR::ComponentAlreadyAttached(e, std::string(typeid(T).name()));
+                throw ERROR::InvalidEntityID(e);
+            }
+
+            /**
+             * @brief Stamps a new component as added and written at the current tick
+             */
+            void stampAdded(std::size_t dense_index) {
+                if (dense_index >= m_added_ticks.size()) {
+                    m_added_ticks.resize(m_data.size());
+                    m_changed_ticks.resize(m_data.size());
+                }
+                m_added_ticks[dense_index] = currentTick();
+                m_changed_ticks[dense_index] = currentTick();
+            }
+
+            /**
+             * @brief Stops recording changes once they outweigh the cache, a plain rebuild is cheaper then
+             */
+            void updateCacheMode() {
+                if (!m_cache_rebuild && m_pending_added.size() + m_pending_removed.size() > m_cached_entities.size() / 2) {
+                    m_cache_rebuild = true;
+                    m_pending_added.clear();
+                    m_pending_removed.clear();
+                }
+            }
+
+            /**
+             * @brief Erases the removed entities from the sorted entity cache, each one is found by binary search
+             * and the entities past the first one found are shifted down once
+             */
+            void erasePendingRemovals() {
+                std::sort(m_pending_removed.begin(), m_pending_removed.end());
+
+                auto last = std::unique(m_pending_removed.begin(), m_pending_removed.end());
+                auto read = m_cached_entities.begin();
+                auto write = m_cached_entities.end();
+
+                for (auto it = m_pending_removed.begin(); it != last; it++) {
+                    // Added back since, it stays cached
+                    if (hasComponent(*it))
+                        continue;
+
+                    auto found = std::lower_bound(read, m_cached_entities.end(), *it);
+
+                    // Added after the last sync, it was never cached
+                    if (found == m_cached_entities.end() || *found != *it)
+                        continue;
+                    write = write == m_cached_entities.end() ? found : std::move(read, found, write);
+                    read = found + 1;
+                }
+                if (write != m_cached_entities.end())
+                    m_cached_entities.erase(std::move(read, m_cached_entities.end(), write), m_cached_entities.end());
+                m_pending_removed.clear();
+            }
+
+            /**
+             * @brief Applies the pending changes to the sorted entity cache
+             */
+            void applyPendingChanges() {
+                if (m_cache_rebuild) {
+                    BLOB_ECS_PROFILE_SCOPE(CACHE_REBUILD_NS);
+
+                    BLOB_ECS_COUNT(CACHE_REBUILDS, 1);
+                    m_cached_entities.clear();
+                    m_cached_entities.reserve(m_data.count());
+                    for (std::size_t i = 0; i < m_data.size(); i++) {
+                        if (m_data.entityAt(i) != NULL_ENTITY)
+                            m_cached_entities.push_back(m_data.entityAt(i));
+                    }
+                    std::sort(m_cached_entities.begin(), m_cached_entities.end());
+                    m_pending_added.clear();
+                    m_pending_removed.clear();
+                    m_cache_rebuild = false;
+                    return;
+                }
+
+                if (!m_pending_removed.empty())
+                    erasePendingRemovals();
+                std::size_t kept = m_cached_entities.size();
+
+                std::sort(m_pending_added.begin(), m_pending_added.end());
+                auto last = std::unique(m_pending_added.begin(), m_pending_added.end());
+                for (auto it = m_pending_added.begin(); it != last; it++) {
+                    // Removed again since, or removed then added back while still cached
+                    if (!hasComponent(*it) || std::binary_search(m_cached_entities.begin(), m_cached_entities.begin() + kept, *it))
+                        continue;
+                    m_cached_entities.push_back(*it);
+                }
+                m_pending_added.clear();
+
+                // Spawning mostly yields increasing IDs, only merge when the new range overlaps
+                if (kept != 0 && kept != m_cached_entities.size() && m_cached_entities[kept] < m_cached_entities[kept - 1])
+                    std::inplace_merge(m_cached_entities.begin(), m_cached_entities.begin() + kept, m_cached_entities.end());
             }
     };
 }
@@ -0,0 +1,130 @@
+/*
+ *  ComponentList
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef COMPONENTLIST_HPP_
+    #define COMPONENTLIST_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <type_traits>
+
+#include "Includes.hpp"
+#include "Component.hpp"
+
+namespace ECS {
+
+    /**
+     * @brief Returns the index of T in a pack of types, the pack's size if T isn't part of it
+     */
+    template<typename T, typename... Ts>
+    constexpr std::size_t typeIndex() {
+        constexpr bool matches[] = {std::is_same_v<T, Ts>..., false};
+        std::size_t i = 0;
+
+        while (i < sizeof...(Ts) && !matches[i])
+            i++;
+        return i;
+    }
+
+    /**
+     * @brief Checks that no two types of a pack have the same stableTypeId(), which also rules out duplicates
+     */
+    template<typename... Ts>
+    constexpr bool distinctStableIds() {
+        constexpr uint32_t ids[] = {stableTypeId<Ts>()..., 0};
+
+        for (std::size_t i = 0; i < sizeof...(Ts); i++) {
+            for (std::size_t j = i + 1; j < sizeof...(Ts); j++) {
+                if (ids[i] == ids[j])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief A fixed set of component types known at compile time, each type's slot is its index in the list
+     *
+     * using Components = ECS::ComponentList<Position, Velocity, Health>;
+     *
+     * ecs.registerComponents<Components>();
+     * ecs.getPool<Velocity, Components>();    // m_pools[1], no lookup
+     *
+     * Types can still be registered at runtime after the list, they take the following slots.
+     *
+     * @tparam Ts The component types, each listed once
+     */
+    template<ComponentType... Ts>
+    struct ComponentList {
+        static_assert(sizeof...(Ts) <= MAX_COMPONENTS, "the component list is longer than MAX_COMPONENTS");
+        static_assert(distinctStableIds<Ts...>(), "a type is listed twice, or two types share a stable ID and one's name must be pinned in its ComponentTraits");
+
+        // Amount of types in the list, the slots they take
+        static constexpr std::size_t size = sizeof...(Ts);
+
+        // stableTypeId() of every type, in list order
+        static constexpr std::array<uint32_t, sizeof...(Ts)> stable_ids = {stableTypeId<Ts>()...};
+
+        /**
+         * @brief True if T is part of the list
+         */
+        template<typename T>
+        static constexpr bool contains = (std::is_same_v<T, Ts> || ...);
+
+        /**
+         * @brief Returns the slot of a type, its index in the list
+         *
+         * @tparam T The type, it must be part of the list
+         * @return std::size_t The slot
+         */
+        template<typename T>
+        static constexpr std::size_t slotOf() {
+            static_assert(contains<T>, "the type isn't part of the component list");
+            return typeIndex<T, Ts...>();
+        }
+
+        /**
+         * @brief Calls a function with every type of the list, in order
+         *
+         * list.forEach([]<typename T>() { ... });
+         */
+        template<typename Func>
+        static constexpr void forEach(Func &&func) {
+            (func.template operator()<Ts>(), ...);
+        }
+    };
+
+    /**
+     * @brief Satisfied by the instantiations of ComponentList
+     */
+    template<typename T>
+    struct isComponentListType : std::false_type {};
+
+    template<typename... Ts>
+    struct isComponentListType<ComponentList<Ts...>> : std::true_type {};
+
+    template<typename T>
+    concept ComponentListType = isComponentListType<T>::value;
+}
+
+#endif /* !COMPONENTLIST_HPP_ */
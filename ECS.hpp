@@ -25,12 +25,14 @@
 
 #include <cstddef>
 #include <vector>
-#include <queue>
 #include <unordered_map>
 #include <string>
 #include <exception>
 #include <system_error>
 #include <algorithm>
+#include <mutex>
+#include <thread>
+#include <memory>
 #include <unistd.h>
 
 #include "Registry.hpp"
@@ -38,6 +40,14 @@
 #include "Includes.hpp"
 #include "Component.hpp"
 #include "System.hpp"
+#include "View.hpp"
+#include "Archetype.hpp"
+#include "ThreadPool.hpp"
+#include "CommandBuffer.hpp"
+#include "Memory.hpp"
+#include "Profiler.hpp"
+#include "Snapshot.hpp"
+#include "Relationship.hpp"
 
 namespace ECS {
     class ECS {
@@ -47,12 +57,13 @@ namespace ECS {
              * 
              * @param max_entities OPTIONAL specify a maximum entity count, 0 = infinite
              * @param use_as_power OPTIONAL specify if the max_entities is to be interpreted as a power of 2 or as a litteral limit (false by default)
+             * @param storage OPTIONAL how components are stored, sparse sets (default) or archetype chunks
              */
-            ECS(std::size_t max_entities = 0, bool use_as_power = false)
+            ECS(std::size_t max_entities = 0, bool use_as_power = false, StorageMode storage = StorageMode::SPARSE_SET)
+            : registry(storage)
             {
-                for (std::size_t i = 0; i < 32; i++) {
-                    m_entities.push_back(Entity());
-                }
+                m_entities.resize(32);
+                registry.bindEntities(&m_entities);
             }
 
             ~ECS() {}
@@ -76,35 +87,23 @@ namespace ECS {
              */
             bool entityIsActive(EntityID e)
             {
-                if (m_entities.size() <= e)
-                    return false;
-                return m_entities[e].isActive;
+                return entityIsAlive(m_entities, e);
             }
 
             /**
              * @brief Create a new entity and returns its ID
              * 
+             * IDs of deleted entities are recycled with a new generation, the stale handles
+             * of the deleted entity never match the new one
+             * 
              * @return EntityID 
+             * @throw ERROR::EntityLimitReached => if every entity index is in use
              */
             EntityID entityCreate()
             {
-                EntityID newId;
+                EntityID newId = reserveEntity();
 
-                if (m_available_ids.size() == 0) {
-                    newId = m_id_counter++;
-                } else {
-                    newId = m_available_ids.front();
-                    m_available_ids.pop();
-                }
-                if (m_active_entities >= m_entities.size()) {
-                    std::size_t current_capacity = m_entities.size();
-                    for (std::size_t i = 0; i < current_capacity; i++) {
-                        m_entities.push_back(Entity());
-                    }
-                }
-                m_entities[newId].isActive = true;
-                m_entities[newId].group = NONE;
-                m_active_entities++;
+                publishEntity(newId, NONE);
                 return newId;
             }
 
@@ -125,6 +124,44 @@ namespace ECS {
                 return e;
             }
 
+            /**
+             * @brief Creates several entities at once, their IDs are contiguous
+             * 
+             * The IDs are taken from never used indices, so that they form a single range.
+             * The entity table grows at most once.
+             * 
+             * @param count The amount of entities to create
+             * @param group OPTIONAL the group of the new entities
+             * @return EntityRange The new entities' IDs
+             * @throw ERROR::EntityLimitReached => if not enough entity indices are left, nothing is created then
+             */
+            EntityRange entityCreateBulk(std::size_t count, EntityGroup group = NONE)
+            {
+                EntityIndex first = m_id_counter.load(std::memory_order_relaxed);
+
+                do {
+                    if (count > static_cast<std::size_t>(ENTITY_INDEX_LIMIT - first))
+                        throw ERROR::EntityLimitReached(ENTITY_INDEX_LIMIT);
+                } while (!m_id_counter.compare_exchange_weak(first, first + static_cast<EntityIndex>(count), std::memory_order_relaxed));
+                if (count == 0)
+                    return EntityRange(first, first);
+
+                EntityIndex last = first + static_cast<EntityIndex>(count - 1);
+
+                publishEntity(makeEntityID(last, m_fresh_generation), group);
+                groupReserve(group, count - 1);
+                m_created_log.reserve(m_created_log.size() + count - 1);
+                for (EntityIndex i = first; i < last; i++) {
+                    m_entities[i].isActive = true;
+                    m_entities[i].generation = m_fresh_generation;
+                    groupInsert(i, group);
+                    m_created_log.push_back(EntityEvent{makeEntityID(i, m_fresh_generation), registry.changeTick()});
+                }
+                m_active_entities += count - 1;
+                BLOB_ECS_COUNT(ENTITY_CREATES, count - 1);
+                return EntityRange(makeEntityID(first, m_fresh_generation), makeEntityID(last, m_fresh_generation) + 1);
+            }
+
             /**
              * @brief Set the group of an entity
              * 
@@ -133,132 +170,499 @@ namespace ECS {
              */
             void entitySetGroup(EntityID id, EntityGroup group)
             {
-                if (m_entities.size() <= id)
+                if (!entityIsActive(id) || m_entities[entityIndex(id)].group == group)
                     return;
-                m_entities[id].group = group;
+                groupErase(entityIndex(id));
+                groupInsert(entityIndex(id), group);
             }
             
             /**
              * @brief Delete an entity corresponding to an ID
              * 
+             * Its children in the hierarchy become roots, see entityDeleteSubtree() to delete them too.
+             * 
              * @param e EntityID
              */
             void entityDelete(EntityID e)
             {
-                if (m_entities.size() <= e)
-                    return;
                 if (!entityIsActive(e))
                     return;
-                m_entities[e].isActive = false;
-                m_available_ids.push(e);
+
+                EntityIndex index = entityIndex(e);
+
+                if (registry.archetypes() == nullptr && registry.componentExists<Relationship>() && m_entities[index].components.test(registry.slotOf<Relationship>()))
+                    unlinkRelationship(e);
+
+                Entity &slot = m_entities[index];
+
+                groupErase(index);
+                slot.isActive = false;
+                slot.generation = (slot.generation + 1) & ENTITY_GENERATION_MASK;
                 m_active_entities--;
+                releaseIndex(index);
+                m_deleted_log.push_back(EntityEvent{e, registry.changeTick()});
+                BLOB_ECS_COUNT(ENTITY_DELETES, 1);
+                BLOB_ECS_PROFILE_SCOPE(ENTITY_DELETE_NS);
                 registry.disableEntity(e);
             }
 
             /**
-             * @brief Returns a vector containing the IDs of entities belonging to group 'group'
+             * @brief Returns the IDs of entities belonging to group 'group', in O(1)
+             * 
+             * Each group keeps a dense list of its members, the span is invalidated by the next
+             * entity creation, deletion or group change. The order is unspecified.
              * 
              * @param group The group to target
-             * @return std::vector<EntityID> The list of entities
+             * @return std::span<const EntityID> The list of entities
+             */
+            std::span<const EntityID> getEntityGroup(EntityGroup group)
+            {
+                if (static_cast<std::size_t>(group) >= m_groups.size())
+                    return {};
+                return m_groups[group];
+            }
+
+            /**
+             * @brief Attaches an entity to a parent, or detaches it, see Relationship
+             * 
+             * The entity keeps its own children. Both entities get a Relationship, registered on first use,
+             * and every link written is tracked so that deltas carry the hierarchy.
+             * 
+             * @param child The entity to move
+             * @param parent The new parent, appended to its children, NULL_ENTITY to make the child a root
+             * @throw ERROR::InvalidEntityID => if an entity isn't active
+             * @throw ERROR::HierarchyCycle => if the parent is the child or one of its descendants
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
              */
-            std::vector<EntityID> getEntityGroup(EntityGroup group)
+            void entitySetParent(EntityID child, EntityID parent)
             {
-                std::vector<EntityID> grp;
+                if (!entityIsActive(child))
+                    throw ERROR::InvalidEntityID(child);
+                if (parent != NULL_ENTITY && !entityIsActive(parent))
+                    throw ERROR::InvalidEntityID(parent);
+                registry.registerComponent<Relationship>();
+
+                ComponentPool<Relationship> &links = registry.getPool<Relationship>();
+
+                for (EntityID it = parent; it != NULL_ENTITY; it = links.hasComponent(it) ? links.getComponent(it).parent : NULL_ENTITY) {
+                    if (it == child)
+                        throw ERROR::HierarchyCycle(child, parent);
+                }
+                if (!links.hasComponent(child))
+                    entityAddComponent<Relationship>(child);
+                if (links.getComponent(child).parent == parent)
+                    return;
+                detachFromParent(links, child);
+                if (parent != NULL_ENTITY) {
+                    if (!links.hasComponent(parent))
+                        entityAddComponent<Relationship>(parent);
 
-                for (std::size_t i = 0; i < m_entities.size(); i++) {
-                    if (m_entities[i].isActive && m_entities[i].group == group)
-                        grp.push_back(i);
+                    Relationship &node = links.markChanged(parent);
+                    Relationship &moved = links.markChanged(child);
+
+                    moved.parent = parent;
+                    moved.prev_sibling = node.last_child;
+                    if (node.last_child != NULL_ENTITY)
+                        links.markChanged(node.last_child).next_sibling = child;
+                    else
+                        node.first_child = child;
+                    node.last_child = child;
+                    node.children++;
                 }
-                return grp;
+                m_hierarchy_sorted = false;
             }
 
             /**
-             * @brief Returns a vector containing the IDs of entities that have ALL specified components
+             * @brief Get the parent of an entity
              * 
-             * @tparam Components The component types to check for (variadic template)
-             * @return std::vector<EntityID> The list of entities that have all specified components
+             * @param e The entity ID
+             * @return EntityID The parent, NULL_ENTITY for a root or an entity outside of the hierarchy
              */
-            template<ComponentType... Components>
-            std::vector<EntityID> getEntitiesByComponentsAllOf()
+            EntityID entityGetParent(EntityID e)
             {
-                if constexpr (sizeof...(Components) == 0) {
-                    return {};
+                if (!entityIsActive(e) || !componentExists<Relationship>() || !entityHasComponent<Relationship>(e))
+                    return NULL_ENTITY;
+                return registry.getPool<Relationship>().getComponent(e).parent;
+            }
+
+            /**
+             * @brief Calls fn(EntityID) for each direct child of an entity, in the order they were attached
+             * 
+             * The hierarchy must not be changed from fn
+             * 
+             * @param e The entity ID
+             * @param fn The function
+             */
+            template<typename Func>
+            void entityForEachChild(EntityID e, Func &&fn)
+            {
+                if (!entityIsActive(e) || !componentExists<Relationship>() || !entityHasComponent<Relationship>(e))
+                    return;
+
+                ComponentPool<Relationship> &links = registry.getPool<Relationship>();
+
+                for (EntityID it = links.getComponent(e).first_child; it != NULL_ENTITY; it = links.getComponent(it).next_sibling)
+                    std::invoke(fn, it);
+            }
+
+            /**
+             * @brief Deletes an entity and all of its descendants
+             * 
+             * The subtree is collected first, then handed to entityDelete() leaves first,
+             * so that each deletion only unlinks a node without children.
+             * 
+             * @param root The entity ID
+             * @return std::size_t The amount of deleted entities
+             */
+            std::size_t entityDeleteSubtree(EntityID root)
+            {
+                if (!entityIsActive(root))
+                    return 0;
+                if (!componentExists<Relationship>() || !entityHasComponent<Relationship>(root)) {
+                    entityDelete(root);
+                    return 1;
                 }
-                
-                std::vector<std::vector<EntityID>> component_lists;
-                
-                (component_lists.push_back(
-                    componentExists<Components>()
-                    ? registry.getPool<Components>().getActiveEntities()
-                    : std::vector<EntityID>{}
-                ), ...);
 
-                if (component_lists.empty()) {
-                    return {};
+                std::vector<EntityID> &subtree = m_hierarchy_order;
+
+                subtree.clear();
+                collectSubtree(registry.getPool<Relationship>(), root, subtree);
+                for (auto it = subtree.rbegin(); it != subtree.rend(); it++)
+                    entityDelete(*it);
+                return subtree.size();
+            }
+
+            /**
+             * @brief Reorders the Relationship pool depth-first, each parent is followed by its whole subtree
+             * 
+             * Roots keep their relative order. propagateHierarchy() calls this when the hierarchy changed
+             * since the last sort, calling it by hand moves the cost out of the propagation,
+             * e.g. to a loading screen. Every Relationship reference is invalidated.
+             * 
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
+             */
+            void sortHierarchy()
+            {
+                if (!componentExists<Relationship>())
+                    return;
+
+                ComponentPool<Relationship> &links = registry.getPool<Relationship>();
+
+                m_hierarchy_order.clear();
+                m_hierarchy_order.reserve(links.size());
+                for (std::size_t i = 0; i < links.size(); i++) {
+                    if (links.entityAt(i) != NULL_ENTITY && links.componentAt(i).parent == NULL_ENTITY)
+                        collectSubtree(links, links.entityAt(i), m_hierarchy_order);
                 }
-                
-                auto smallest_it = std::min_element(component_lists.begin(), component_lists.end(),
-                    [](const std::vector<EntityID>& a, const std::vector<EntityID>& b) {
-                        return a.size() < b.size();
-                    });
+                links.arrange(m_hierarchy_order);
+
+                m_hierarchy_parents.resize(links.size());
+                for (std::size_t i = 0; i < links.size(); i++) {
+                    EntityID parent = links.componentAt(i).parent;
 
-                std::vector<EntityID> result = *smallest_it;
+                    m_hierarchy_parents[i] = parent == NULL_ENTITY ? NULL_INDEX : static_cast<uint32_t>(links.denseIndexOf(parent));
+                }
+                m_hierarchy_sorted = true;
+            }
+
+            /**
+             * @brief Visits the hierarchy top-down in one linear sweep: fn(const T *parent, T &node)
+             * for every entity of the hierarchy that has a T, parents before their children
+             * 
+             * ecs.propagateHierarchy<Transform>([](const Transform *parent, Transform &node) {
+             *     node.world = parent ? parent->world * node.local : node.local;
+             * });
+             * 
+             * The hierarchy is sorted first if it changed, see sortHierarchy(), and the T pool is aligned
+             * to it if needed, see ComponentPool::alignTo(). A steady hierarchy then costs two sequential
+             * passes over the pools and no lookup. parent is nullptr for roots and for entities
+             * whose parent lacks a T. Writes to node are not tracked, and fn must not change the hierarchy.
+             * 
+             * @tparam T The component type to propagate
+             * @param fn The function
+             * @throw ERROR::UnregisteredComponent => if T isn't registered
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
+             */
+            template<ComponentType T, typename Func>
+            void propagateHierarchy(Func &&fn)
+            {
+                ComponentPool<T> &pool = registry.getPool<T>();
+
+                if (!componentExists<Relationship>())
+                    return;
+
+                ComponentPool<Relationship> &links = registry.getPool<Relationship>();
 
-                for (const auto& comp_list : component_lists) {
-                    if (&comp_list == &(*smallest_it)) continue;
-                    
-                    std::vector<EntityID> intersection;
-                    std::set_intersection(result.begin(), result.end(),
-                                        comp_list.begin(), comp_list.end(),
-                                        std::back_inserter(intersection));
-                    result = std::move(intersection);
-                    
-                    if (result.empty()) break;
+                if (!m_hierarchy_sorted || m_hierarchy_parents.size() != links.size())
+                    sortHierarchy();
+                if (!matchHierarchy(links, pool)) {
+                    pool.alignTo(links);
+                    matchHierarchy(links, pool);
                 }
+                for (std::size_t i = 0; i < links.size(); i++) {
+                    uint32_t cell = m_hierarchy_cells[i];
 
-                return result;
+                    if (cell == NULL_INDEX)
+                        continue;
+
+                    uint32_t parent = m_hierarchy_parents[i];
+                    const T *parent_value = nullptr;
+
+                    if (parent != NULL_INDEX && m_hierarchy_cells[parent] != NULL_INDEX)
+                        parent_value = &pool.componentAt(m_hierarchy_cells[parent]);
+                    std::invoke(fn, parent_value, pool.componentAt(cell));
+                }
             }
 
             /**
-             * @brief Returns a vector containing the IDs of entities that have AT LEAST ONE of the specified components
+             * @brief Returns a view over every entity that has ALL specified components
+             * 
+             * The view does not allocate, it can be iterated with each() or a range-for:
+             * for (auto [e, pos, vel] : ecs.view<Position, Velocity>())
+             * 
+             * @tparam Components The component types to check for (variadic template), or Changed<T> / Added<T> terms
+             * @return View<Components...> The view, empty if any of the components isn't registered
+             */
+            template<ComponentType... Components>
+            View<Components...> view()
+            {
+                if (!(componentExists<TermComponent<Components>>() && ...))
+                    return View<Components...>(static_cast<ComponentPool<TermComponent<Components>> *>(nullptr)...);
+
+                ComponentMask mask = registry.maskOf<TermComponent<Components>...>();
+
+                if (ArchetypeStorage *archetypes = registry.archetypes())
+                    return View<Components...>(archetypes, &m_entities, mask, {registry.slotOf<TermComponent<Components>>()...});
+                return View<Components...>(&m_entities, mask, &registry.getPool<TermComponent<Components>>()...);
+            }
+
+            /**
+             * @brief Returns a view whose Changed<T> / Added<T> terms only keep what changed since the system's previous run
+             * 
+             * ecs.view<Changed<Position>>(id).each([](EntityID e, Position &pos) { ... });
+             * 
+             * Change tracking is only available with sparse sets, the terms match every entity over archetype storage.
+             * 
+             * @tparam Components The component types to check for (variadic template), or Changed<T> / Added<T> terms
+             * @param sys The ID of the system running the query
+             * @return View<Components...> The view
+             */
+            template<ComponentType... Components>
+            View<Components...> view(SystemID sys)
+            {
+                View<Components...> v = view<Components...>();
+
+                if (sys < m_systems.size())
+                    v.since(m_systems[sys].last_run);
+                return v;
+            }
+
+            /**
+             * @brief Returns a view over every entity that has ALL specified components and NONE of the excluded ones
+             * 
+             * for (auto [e, pos, vel] : ecs.view<Position, Velocity>(NoneOf<Frozen>{}))
              * 
              * @tparam Components The component types to check for (variadic template)
-             * @return std::vector<EntityID> The list of entities that have at least one of the specified components
+             * @tparam Excluded The component types the entities must not have, unregistered ones are ignored
+             * @return View<Components...> The view
+             */
+            template<ComponentType... Components, ComponentType... Excluded>
+            View<Components...> view(NoneOf<Excluded...>)
+            {
+                View<Components...> v = view<Components...>();
+                ComponentMask excluded;
+
+                ((componentExists<Excluded>() ? excluded.set(registry.slotOf<Excluded>()) : void()), ...);
+                v.exclude(excluded);
+                return v;
+            }
+
+            /**
+             * @brief Builds the signature mask of a set of components, to be reused with entityMatches()
+             * 
+             * @tparam Components The component types
+             * @return ComponentMask The mask
+             * @throw ERROR::UnregisteredComponent => if a component isn't registered
              */
             template<ComponentType... Components>
-            std::vector<EntityID> getEntitiesByComponentsAnyOf()
+            ComponentMask componentMask()
+            {
+                return registry.maskOf<Components...>();
+            }
+
+            /**
+             * @brief Checks if an entity is active and has ALL of the specified components
+             * 
+             * @tparam Components The component types
+             * @param e EntityID
+             * @return true If the entity has every component, false if one is missing or not registered
+             */
+            template<ComponentType... Components>
+            bool entityMatches(EntityID e)
+            {
+                if (!(componentExists<Components>() && ...))
+                    return false;
+                return entityMatches(e, registry.maskOf<Components...>());
+            }
+
+            /**
+             * @brief Checks if an entity is active and has ALL of the components of a mask, with a single mask compare
+             * 
+             * @param e EntityID
+             * @param mask The mask, see componentMask()
+             * @return true If every bit of the mask is set in the entity's signature
+             */
+            bool entityMatches(EntityID e, const ComponentMask &mask)
+            {
+                return entityIsActive(e) && m_entities[entityIndex(e)].components.containsAll(mask);
+            }
+
+            /**
+             * @brief Returns a vector containing the IDs of entities that have ALL specified components
+             * 
+             * Prefer view() in hot paths, this builds a sorted copy of the view's entities
+             * 
+             * @tparam Components The component types to check for (variadic template)
+             * @return std::vector<EntityID> The sorted list of entities that have all specified components
+             */
+            template<ComponentType... Components>
+            std::vector<EntityID> getEntitiesByComponentsAllOf()
+            {
+                return getEntitiesByComponentsAllOf<Components...>(NoneOf<>{});
+            }
+
+            /**
+             * @brief Returns a vector containing the IDs of entities that have ALL specified components and NONE of the excluded ones
+             * 
+             * ecs.getEntitiesByComponentsAllOf<Position, Velocity>(NoneOf<Frozen>{});
+             * 
+             * @tparam Components The component types to check for (variadic template)
+             * @tparam Excluded The component types the entities must not have
+             * @return std::vector<EntityID> The sorted list of matching entities
+             */
+            template<ComponentType... Components, ComponentType... Excluded>
+            std::vector<EntityID> getEntitiesByComponentsAllOf(NoneOf<Excluded...> excluded)
             {
                 if constexpr (sizeof...(Components) == 0) {
                     return {};
+                } else {
+                    View<Components...> v = view<Components...>(excluded);
+                    std::vector<EntityID> result;
+
+                    result.reserve(v.sizeHint());
+                    v.each([&result](EntityID e, auto &...) { result.push_back(e); });
+                    std::sort(result.begin(), result.end());
+                    return result;
                 }
+            }
 
+            /**
+             * @brief Returns a vector containing the IDs of entities that have AT LEAST ONE of the specified components
+             * 
+             * @tparam Components The component types to check for (variadic template)
+             * @return std::vector<EntityID> The sorted list of entities that have at least one of the specified components
+             */
+            template<ComponentType... Components>
+            std::vector<EntityID> getEntitiesByComponentsAnyOf()
+            {
                 std::vector<EntityID> result;
-                
-                auto addEntities = [&result](const std::vector<EntityID>& entities) {
-                    for (EntityID id : entities) {
-                        if (std::find(result.begin(), result.end(), id) == result.end()) {
-                            result.push_back(id);
+
+                getEntitiesByComponentsAnyOf<Components...>(result);
+                return result;
+            }
+
+            /**
+             * @brief Writes the IDs of entities that have AT LEAST ONE of the specified components in a caller-provided buffer
+             * 
+             * The pools' sorted entity lists are merged in a single pass, in O(n * k) for k component types.
+             * The buffer is cleared first, it doesn't allocate once its capacity is large enough.
+             * 
+             * @tparam Components The component types to check for (variadic template)
+             * @param result The buffer, receives the sorted list of entities
+             */
+            template<ComponentType... Components>
+            void getEntitiesByComponentsAnyOf(std::vector<EntityID> &result)
+            {
+                result.clear();
+                if constexpr (sizeof...(Components) != 0) {
+                    if (ArchetypeStorage *archetypes = registry.archetypes()) {
+                        ComponentMask mask;
+
+                        // An entity is in a single archetype, no duplicate can show up
+                        ((componentExists<Components>() ? mask.set(registry.slotOf<Components>()) : void()), ...);
+                        for (std::size_t i = 0; i < archetypes->archetypeCount(); i++) {
+                            Archetype &archetype = archetypes->archetypeAt(i);
+
+                            if (!archetype.mask().intersects(mask))
+                                continue;
+                            for (std::size_t row = 0; row < archetype.size(); row++)
+                                result.push_back(archetype.entityAt(row));
                         }
+                        std::sort(result.begin(), result.end());
+                        return;
                     }
-                };
-                
-                ((componentExists<Components>()
-                    ? addEntities(registry.getPool<Components>().getActiveEntities())
-                    : void()
-                ), ...);
-                
-                std::sort(result.begin(), result.end());
-                
-                return result;
+
+                    std::span<const EntityID> lists[] = {
+                        (componentExists<Components>() ? std::span<const EntityID>(registry.getPool<Components>().getActiveEntities()) : std::span<const EntityID>())...
+                    };
+                    std::size_t heads[sizeof...(Components)] = {};
+                    std::size_t total = 0;
+
+                    for (const auto &it : lists)
+                        total += it.size();
+                    result.reserve(total);
+                    while (true) {
+                        EntityID next = NULL_ENTITY;
+                        bool found = false;
+
+                        for (std::size_t i = 0; i < sizeof...(Components); i++) {
+                            if (heads[i] < lists[i].size() && (!found || lists[i][heads[i]] < next)) {
+                                next = lists[i][heads[i]];
+                                found = true;
+                            }
+                        }
+                        if (!found)
+                            break;
+                        result.push_back(next);
+                        for (std::size_t i = 0; i < sizeof...(Components); i++) {
+                            if (heads[i] < lists[i].size() && lists[i][heads[i]] == next)
+                                heads[i]++;
+                        }
+                    }
+                }
             }
 
             /**
              * @brief Registers a new component in the environment, the component can then be used withing the environment
              * 
+             * Pools don't allocate anything until used, pass the expected component count to reserve it up front
+             * 
              * @tparam T The type of the component to register
+             * @param capacity_hint OPTIONAL amount of components to reserve room for
              */
             template<ComponentType T>
-            void registerComponent() { registry.registerComponent<T>(); }
+            void registerComponent(std::size_t capacity_hint = 0) { registry.registerComponent<T>(capacity_hint); }
+
+            /**
+             * @brief Registers the types of a component list, their slots become compile-time constants, see ComponentList
+             * 
+             * Register the list before any other type
+             * 
+             * @tparam List The ComponentList
+             * @param capacity_hint OPTIONAL amount of components every pool reserves room for
+             * @throw ERROR::ComponentListMismatch => if other types were registered first
+             */
+            template<ComponentListType List>
+            void registerComponents(std::size_t capacity_hint = 0) { registry.registerComponents<List>(capacity_hint); }
+
+            /**
+             * @brief Sets the memory resource the component storage allocates from, e.g. an arena over a HugePageResource
+             * 
+             * Only applies to components registered afterwards, the resource must outlive the ECS
+             * 
+             * @param resource The resource, nullptr for the default one
+             */
+            void setMemoryResource(std::pmr::memory_resource *resource) { registry.setMemoryResource(resource); }
 
             /**
              * @brief Checks if the component type is registered
@@ -279,19 +683,54 @@ namespace ECS {
              * @return false Either if the entity doesn't exists or if the component isn't attached to it
              */
             template<ComponentType T>
-            bool entityHasComponent(EntityID e) { return registry.getPool<T>().hasComponent(e); }
+            bool entityHasComponent(EntityID e)
+            {
+                std::size_t slot = registry.slotOf<T>();
+
+                return entityIsActive(e) && m_entities[entityIndex(e)].components.test(slot);
+            }
 
             /**
              * @brief Add a new component to the specified entity
              * 
+             * With StorageMode::ARCHETYPE, component references are invalidated by the next
+             * structural change of an entity with the same components
+             * 
              * @tparam T The component type to add to the entity
              * @param e EntityID - The entity to add the component to
              * @return T& Reference to the newly created Component
+             * @throw ERROR::InvalidEntityID => if the entity isn't active, stale handles included
              * @throw ERROR::UnregisteredComponent => if the component isn't registered
              * @throw ERROR::ComponentAlreadyAttached => if the component is ALREADY attached to the entity
              */
             template<ComponentType T>
-            T &entityAddComponent(EntityID e) { return registry.getPool<T>().addComponent(e); }
+            T &entityAddComponent(EntityID e)
+            {
+                if (!entityIsActive(e))
+                    throw ERROR::InvalidEntityID(e);
+                return registry.addComponent<T>(e);
+            }
+
+            /**
+             * @brief Adds a copy of a component to every specified entity, see ComponentPool::addComponentBulk()
+             * 
+             * @tparam T The component type to add
+             * @tparam Range A forward range of EntityID, e.g. the EntityRange returned by entityCreateBulk()
+             * @param entities The entities
+             * @param prototype OPTIONAL the value every new component is copied from
+             * @throw ERROR::InvalidEntityID => if an entity isn't active, nothing is added then
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::ComponentAlreadyAttached => if an entity already has the component or shows up twice, nothing is added then
+             */
+            template<ComponentType T, std::ranges::forward_range Range>
+            void entityAddComponentBulk(const Range &entities, const T &prototype = T())
+            {
+                for (EntityID e : entities) {
+                    if (!entityIsActive(e))
+                        throw ERROR::InvalidEntityID(e);
+                }
+                registry.addComponentBulk<T>(entities, prototype);
+            }
 
             /**
              * @brief Gets the attached specified component to the specified entity
@@ -299,56 +738,196 @@ namespace ECS {
              * @tparam T The component type to get
              * @param e EntityID - The entity's ID
              * @return T& Reference to the associated component
+             * @throw ERROR::InvalidEntityID => if the entity isn't active, stale handles included
              * @throw ERROR::UnregisteredComponent => if the component isn't registered
              * @throw ERROR::ComponentNotAttached => if the component is NOT attached to the entity
              */
             template<ComponentType T>
-            T &entityGetComponent(EntityID e) { return registry.getPool<T>().getComponent(e); }
+            T &entityGetComponent(EntityID e)
+            {
+                if (!entityIsActive(e))
+                    throw ERROR::InvalidEntityID(e);
+                if (!entityHasComponent<T>(e))
+                    throw ERROR::ComponentNotAttached(e, std::string(typeid(T).name()));
+                return registry.getComponent<T>(e);
+            }
 
             /**
-             * @brief Removes the attached component from the entity
+             * @brief Removes the attached component from the entity, if any
              * 
              * @tparam T The component type
              * @param e The entity ID
+             * @throw ERROR::InvalidEntityID => if the entity isn't active, stale handles included
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
              */
             template<ComponentType T>
-            void entityRemoveComponent(EntityID e) { registry.getPool<T>().removeComponent(e); }
+            void entityRemoveComponent(EntityID e)
+            {
+                if (!entityIsActive(e))
+                    throw ERROR::InvalidEntityID(e);
+                registry.removeComponent<T>(e);
+            }
 
             /**
-             * @brief Get the Pool object
+             * @brief Gets a component to write to it, the write shows in the Changed<T> views of the systems running later
              * 
-             * @tparam T The component type of the Pool
-             * @return ComponentPool<T>* The pointer to the pool
+             * Writes through entityGetComponent() or a view are not tracked, only this and command buffer assignments are.
+             * 
+             * @tparam T The component type
+             * @param e The entity ID
+             * @return T& Reference to the component
              * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
+             * @throw ERROR::ComponentNotAttached => if the component is NOT attached to the entity
              */
             template<ComponentType T>
-            ComponentPool<T> &getPool() { return registry.getPool<T>(); }
-
-            /**
-             * @brief Adds a new system to the ECS
-             * 
-             * @tparam T The system class
-             * @param tickrate The ticks (calls to Update()) the system should skip after ticked
-             * @return SystemID The new ID for the system
-             */
-            template<SystemClass T>
-            SystemID addSystem(int tickrate = 0)
+            T &entityMarkChanged(EntityID e)
             {
-                static SystemID id = 0;
-                SystemData data;
+                ComponentPool<T> &pool = registry.getPool<T>();
 
-                data.enabled = true;
-                data.sys = new T();
-                data.tickrate = tickrate;
-                data.skipped_ticks = 0;
-                m_systems.push_back(data);
-                return id++;
+                if (!pool.hasComponent(e))
+                    throw ERROR::ComponentNotAttached(e, std::string(typeid(T).name()));
+                return pool.markChanged(e);
             }
 
             /**
-             * @brief Toggles the system on or off, defining if it should tick when Update() is called
+             * @brief Returns the entities that lost their T since the system's previous run, deleted entities included
              * 
-             * @param id The id of the system to toggle
+             * @tparam T The component type
+             * @param sys The ID of the system asking
+             * @return std::span<const EntityID> The entities, oldest removal first, valid until the next structural change
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
+             */
+            template<ComponentType T>
+            std::span<const EntityID> entitiesRemovedSince(SystemID sys)
+            {
+                return registry.getPool<T>().removedSince(sys < m_systems.size() ? m_systems[sys].last_run : 0);
+            }
+
+            /**
+             * @brief Returns a change tick to be given to View::since() or writeDeltaSince() outside of systems
+             * 
+             * Changes are stamped with the current tick until Update() moves it on, so the tick before it is
+             * returned: View::since(tick) shows what changed from then on, along with the changes stamped
+             * earlier in the current tick. Nothing is missed, the current tick's changes may show twice.
+             * 
+             * @return uint32_t The tick
+             */
+            uint32_t changeTick()
+            {
+                return registry.changeTick() - 1;
+            }
+
+            /**
+             * @brief Get the Pool object
+             * 
+             * @tparam T The component type of the Pool
+             * @return ComponentPool<T>* The pointer to the pool
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
+             */
+            template<ComponentType T>
+            ComponentPool<T> &getPool() { return registry.getPool<T>(); }
+
+            /**
+             * @brief Get the Pool object of a type of a component list, without any lookup, see registerComponents()
+             * 
+             * @tparam T The component type of the Pool, part of List
+             * @tparam List The registered ComponentList
+             * @return ComponentPool<T>& The pool
+             * @throw ERROR::ComponentListMismatch => if List wasn't registered, only checked without NDEBUG
+             */
+            template<ComponentType T, ComponentListType List>
+            ComponentPool<T> &getPool() { return registry.getPool<T, List>(); }
+
+            /**
+             * @brief Reorders the follower pools to match the dense order of the lead pool, see ComponentPool::alignTo()
+             *
+             * view<Lead, Follow...>() then reads every pool sequentially, sort the lead first with
+             * ComponentPool::sortBy() for a spatial order.
+             *
+             * @tparam Lead The component type whose order is followed
+             * @tparam Follow The component types to reorder
+             * @param budget OPTIONAL lead cells each follower visits during this call, 0 = everything at once.
+             * Call it once per frame with a budget to spread the work.
+             * @return true If every follower is aligned
+             * @return false If some still have work left
+             * @throw ERROR::UnregisteredComponent => if a component isn't registered
+             * @throw ERROR::NoComponentPool => if the world uses StorageMode::ARCHETYPE
+             */
+            template<ComponentType Lead, ComponentType... Follow>
+            bool alignPools(std::size_t budget = 0)
+            {
+                const ComponentPool<Lead> &lead = registry.getPool<Lead>();
+
+                return (registry.getPool<Follow>().alignTo(lead, budget) & ...);
+            }
+
+            /**
+             * @brief Adds a new system to the ECS
+             * 
+             * @tparam T The system class
+             * @param tickrate The ticks (calls to Update()) the system should skip after ticked
+             * @return SystemID The new ID for the system
+             */
+            template<SystemClass T>
+            SystemID addSystem(int tickrate = 0)
+            {
+                SystemData data;
+
+                data.enabled = true;
+                data.sys = std::make_unique<T>();
+                data.tickrate = tickrate;
+                data.skipped_ticks = 0;
+                declareSystemAccess<T>(data);
+                m_systems.push_back(std::move(data));
+                m_schedule_dirty = true;
+#ifdef BLOB_ECS_PROFILING
+                m_profiler.declare(static_cast<SystemID>(m_systems.size() - 1), std::string(typeName<T>()));
+#endif
+                return static_cast<SystemID>(m_systems.size() - 1);
+            }
+
+            /**
+             * @brief Adds systems known at compile time, see SystemPipeline
+             * 
+             * Each system gets its own consecutive ID, to be toggled or queried like the ones of addSystem().
+             * Run one after another, the pipeline costs a single indirect call per Update().
+             * 
+             * @tparam Systems The system classes, in execution order
+             * @param tickrate The ticks (calls to Update()) each system should skip after ticked
+             * @return SystemID The ID of the first system, the others follow in order
+             */
+            template<PipelineSystem... Systems>
+            SystemID addPipeline(int tickrate = 0)
+            {
+                SystemID first = static_cast<SystemID>(m_systems.size());
+                std::size_t index = 0;
+
+                m_pipelines.push_back(std::make_unique<SystemPipeline<Systems...>>());
+                ([&]() {
+                    SystemData data;
+
+                    data.enabled = true;
+                    data.pipeline = m_pipelines.back().get();
+                    data.pipeline_index = index++;
+                    data.tickrate = tickrate;
+                    data.skipped_ticks = 0;
+                    declareSystemAccess<Systems>(data);
+                    m_systems.push_back(std::move(data));
+#ifdef BLOB_ECS_PROFILING
+                    m_profiler.declare(static_cast<SystemID>(m_systems.size() - 1), std::string(typeName<Systems>()));
+#endif
+                }(), ...);
+                m_schedule_dirty = true;
+                return first;
+            }
+
+            /**
+             * @brief Toggles the system on or off, defining if it should tick when Update() is called
+             * 
+             * @param id The id of the system to toggle
              */
             void toggleSystem(SystemID id)
             {
@@ -371,33 +950,1252 @@ namespace ECS {
                 return m_systems[sys].enabled;
             }
 
+            /**
+             * @brief Runs a system at a fixed real-time period instead of once per Update()
+             * 
+             * The msecs given to Update() are accumulated, the system runs once per whole period
+             * and receives the period as its msecs. Its tickrate is ignored meanwhile.
+             * 
+             * @param sys The system's ID
+             * @param period_msecs The timestep, 0 to go back to the tickrate
+             * @param max_steps OPTIONAL runs per Update() at most, the time beyond is dropped so a spike can't snowball
+             */
+            void setSystemPeriod(SystemID sys, uint32_t period_msecs, uint32_t max_steps = 4)
+            {
+                if (sys >= m_systems.size())
+                    return;
+                m_systems[sys].period = period_msecs;
+                m_systems[sys].max_steps = std::max<uint32_t>(max_steps, 1);
+                m_systems[sys].accumulator = 0;
+            }
+
+            /**
+             * @brief Returns how far a fixed timestep system is into its next step, to interpolate between steps
+             * 
+             * @param sys The system's ID
+             * @return float The accumulated time divided by the period, in [0, 1), 0 without a period
+             */
+            float systemStepAlpha(SystemID sys) const
+            {
+                if (sys >= m_systems.size() || m_systems[sys].period == 0)
+                    return 0.0f;
+                return static_cast<float>(m_systems[sys].accumulator) / static_cast<float>(m_systems[sys].period);
+            }
+
+            /**
+             * @brief Gives a system a time budget per run, see systemBudgetExhausted()
+             * 
+             * Nothing preempts the system, it is meant to poll its budget, stop once it is exhausted
+             * and resume from where it stopped on its next run, e.g. pathfinding requests or LOD rebuilds
+             * 
+             * @param sys The system's ID
+             * @param budget The time a run may take, 0 = unlimited
+             */
+            void setSystemBudget(SystemID sys, std::chrono::nanoseconds budget)
+            {
+                if (sys >= m_systems.size())
+                    return;
+                m_systems[sys].budget = budget;
+            }
+
+            /**
+             * @brief Checks if a running system used up its budget, it should then yield until its next run
+             * 
+             * This reads the clock, poll it every few work items rather than after each one
+             * 
+             * @param sys The ID of the running system
+             * @return true If the system has a budget and its run lasted longer
+             * @return false otherwise
+             */
+            bool systemBudgetExhausted(SystemID sys) const
+            {
+                if (sys >= m_systems.size() || m_systems[sys].budget.count() == 0)
+                    return false;
+                return std::chrono::steady_clock::now() >= m_systems[sys].deadline;
+            }
+
+#ifdef BLOB_ECS_PROFILING
+            /**
+             * @brief Returns the timings of the systems, only available with BLOB_ECS_PROFILING
+             * 
+             * ecs.profiler().timings(id).p99;
+             * ECS::ProfileCounters::get(ECS::ProfileCounter::CACHE_REBUILDS);
+             * 
+             * @return SystemProfiler& The profiler of this world
+             */
+            SystemProfiler &profiler()
+            {
+                return m_profiler;
+            }
+#endif
+
+            /**
+             * @brief Sets the pool Update() runs systems on, nullptr (the default) runs them one after another
+             * 
+             * With a pool, systems whose declared reads/writes don't conflict run at the same time,
+             * conflicting systems keep their registration order. Systems running in parallel must not
+             * make structural changes (entity creation/deletion, component addition/removal).
+             * 
+             * @param pool The pool to use, e.g. &ThreadPool::shared()
+             */
+            void setThreadPool(ThreadPool *pool)
+            {
+                m_thread_pool = pool;
+            }
+
             /**
              * @brief Updates every active systems
              * 
+             * Each system runs at a new change tick, see view(SystemID).
+             * Fixed timestep systems may run several times or not at all, see setSystemPeriod().
+             * The flushed commands are stamped with a tick of their own, so every system sees them on its next run.
+             * 
+             * @param msecs OPTIONAL the time elapsed since the previous call, given to the systems
              */
             void Update(uint32_t msecs = 0)
             {
-                for (SystemID i = 0; i < m_systems.size(); i++) {
-                    auto &it = m_systems.at(i);
-                    if (!it.enabled)
-                        continue;
-                    if (it.skipped_ticks >= it.tickrate) {
-                        it.sys->Update(*this, i, msecs);
-                        it.skipped_ticks = 0;
-                    } else {
-                        it.skipped_ticks++;
+                {
+                    std::lock_guard<std::mutex> lock(m_command_mutex);
+
+                    fillIdCaches();
+                }
+                if (m_thread_pool != nullptr) {
+                    updateParallel(msecs);
+                } else {
+                    for (SystemID i = 0; i < m_systems.size(); i++) {
+                        SystemData &data = m_systems[i];
+
+                        // A pipeline schedules its own systems, they are skipped here
+                        if (data.pipeline != nullptr) {
+                            if (data.pipeline_index == 0)
+                                data.pipeline->Update(*this, i, msecs);
+                            continue;
+                        }
+                        runSystem(i, msecs, [&](uint32_t step_msecs) { data.sys->Update(*this, i, step_msecs); });
                     }
                 }
+                registry.advanceChangeTick();
+                flushCommands();
+                trimRemovals();
+                if (m_compact_policy.interval != 0 && ++m_compact_countdown >= m_compact_policy.interval) {
+                    m_compact_countdown = 0;
+                    compactStep();
+                }
+            }
+
+            /**
+             * @brief Sets when the world gives back the memory it doesn't use anymore
+             * 
+             * With an interval, Update() runs one step of compactStep() every interval calls, so that
+             * a world that peaked gets back to the footprint of its current population over a few frames.
+             * 
+             * @param policy The policy
+             */
+            void setCompactPolicy(const CompactPolicy &policy)
+            {
+                m_compact_policy = policy;
+                m_compact_countdown = 0;
+            }
+
+            /**
+             * @brief Get the compaction policy, see setCompactPolicy()
+             */
+            const CompactPolicy &compactPolicy() const
+            {
+                return m_compact_policy;
+            }
+
+            /**
+             * @brief Gives back the memory the world doesn't use anymore, all at once, see compactStep()
+             * 
+             * Must not be called while systems are running.
+             */
+            void compact()
+            {
+                m_compact_cursor = 0;
+                while (!compactNext(0));
+            }
+
+            /**
+             * @brief Runs one step of the compaction, each step handles a single structure:
+             * the entity table first, then each component pool, then the archetypes
+             * 
+             * The entity table drops the free IDs past the last entity in use, CompactPolicy::step_entities
+             * at most per step, then the table itself is shrunk under the policy's utilization. Pools trim their sparse
+             * page table and shrink their dense storage under the policy's utilization, archetypes release
+             * their unused chunks, see ComponentPool::shrink(). Pools that shrink move their components.
+             * Entity IDs are never renumbered: fresh IDs start at the highest generation dropped,
+             * so stale handles of the dropped IDs still never match.
+             * Must not be called while systems are running.
+             * 
+             * @return true If the step ended a round, the next one starts over with the entity table
+             * @return false If structures are left in this round
+             */
+            bool compactStep()
+            {
+                return compactNext(m_compact_policy.step_entities);
+            }
+
+            /**
+             * @brief Returns the command buffer of the calling thread
+             * 
+             * Structural changes recorded in it are applied at the next flushCommands(),
+             * which Update() calls once every system ran. This is the way to create or delete entities
+             * and to add or remove components from systems running in parallel or from parallelForEach().
+             * 
+             * @return CommandBuffer& The buffer, only to be used by the calling thread
+             */
+            CommandBuffer &commands()
+            {
+                thread_local struct {
+                    uint64_t world = 0;
+                    CommandBuffer *buffer = nullptr;
+                } cache;
+
+                if (cache.world == m_world_uid)
+                    return *cache.buffer;
+
+                std::lock_guard<std::mutex> lock(m_command_mutex);
+                std::thread::id thread = std::this_thread::get_id();
+                auto it = std::find_if(m_command_buffers.begin(), m_command_buffers.end(),
+                    [&thread](const auto &buffer) { return buffer.first == thread; });
+
+                if (it == m_command_buffers.end()) {
+                    m_command_buffers.emplace_back(thread, std::make_unique<CommandBuffer>(*this));
+                    it = std::prev(m_command_buffers.end());
+                }
+                cache.world = m_world_uid;
+                cache.buffer = it->second.get();
+                return *cache.buffer;
+            }
+
+            /**
+             * @brief Writes the whole world as raw blocks: the entity table, the free list, the groups and every pool
+             * 
+             * Every component type must be trivially copyable. Pools are identified by typeName<T>(), so the snapshot
+             * loads in any build of the same compiler, or across compilers for the names pinned in ComponentTraits,
+             * into a world that registered the same components in the same order. Must not be called while systems are running.
+             * 
+             * @param out The stream to write to, opened in binary mode
+             * @throw ERROR::SnapshotError => with StorageMode::ARCHETYPE, or if a component isn't trivially copyable
+             */
+            void saveSnapshot(std::ostream &out) const
+            {
+                static_assert(std::is_trivially_copyable_v<Entity>);
+                SnapshotWriter writer(out);
+
+                writer.value<uint32_t>(SNAPSHOT_MAGIC);
+                writer.value<uint32_t>(SNAPSHOT_VERSION);
+                writer.block(std::span<const Entity>(m_entities));
+                writer.value<EntityIndex>(m_id_counter.load(std::memory_order_relaxed));
+                writer.value<EntityIndex>(m_free_head);
+                writer.value<EntityIndex>(m_free_tail);
+                writer.value<uint32_t>(m_fresh_generation);
+                writer.value<uint64_t>(m_active_entities);
+                writer.value<uint64_t>(m_groups.size());
+                for (const auto &members : m_groups)
+                    writer.block(std::span<const EntityID>(members));
+                registry.saveSnapshot(writer);
+            }
+
+            /**
+             * @brief Replaces the whole world with a snapshot written by saveSnapshot(), each block is copied in one go
+             * 
+             * Systems are kept, every loaded component counts as added at the current change tick.
+             * IDs the source world's command buffers had reserved or cached are free in the loaded one.
+             * The entity table, the free list and the groups are checked before they replace the world's,
+             * the world is left in an unspecified state if a pool is rejected.
+             * 
+             * @param data The snapshot
+             * @throw ERROR::SnapshotError => if the snapshot is truncated or corrupted, from another version or doesn't match the registered components
+             */
+            void loadSnapshot(std::span<const std::byte> data)
+            {
+                SnapshotReader reader(data);
+
+                if (reader.value<uint32_t>() != SNAPSHOT_MAGIC || reader.value<uint32_t>() != SNAPSHOT_VERSION)
+                    throw ERROR::SnapshotError("not a snapshot of this version");
+
+                std::size_t entities = reader.blockSize<Entity>();
+                std::vector<Entity> table(std::max<std::size_t>(entities, 1), Entity());
+
+                reader.copy(table.data(), entities);
+
+                // Indices past the table were reserved and never published, they are handed out again
+                EntityIndex counter = static_cast<EntityIndex>(std::min<std::size_t>(reader.value<EntityIndex>(), entities));
+                EntityIndex free_head = reader.value<EntityIndex>();
+                EntityIndex free_tail = reader.value<EntityIndex>();
+                uint32_t fresh_generation = reader.value<uint32_t>();
+                uint64_t active = reader.value<uint64_t>();
+                // Each group takes at least its block's length
+                std::vector<std::vector<EntityID>> groups(reader.blockSize(sizeof(uint64_t)));
+
+                for (auto &members : groups) {
+                    members.resize(reader.blockSize<EntityID>());
+                    reader.copy(members.data(), members.size());
+                }
+                if (fresh_generation > ENTITY_GENERATION_MASK)
+                    throw ERROR::SnapshotError("corrupted entity table");
+                checkSnapshotTable(table, counter, free_head, free_tail, groups, active);
+
+                m_entities = std::move(table);
+                m_id_counter.store(counter, std::memory_order_relaxed);
+                m_free_head = free_head;
+                m_free_tail = free_tail;
+                m_fresh_generation = fresh_generation;
+                m_active_entities = static_cast<std::size_t>(active);
+                m_groups = std::move(groups);
+                {
+                    // The caches refer to the replaced table
+                    std::lock_guard<std::mutex> lock(m_command_mutex);
+
+                    for (auto &[thread, buffer] : m_command_buffers)
+                        buffer->m_free_ids.clear();
+                }
+                // IDs reserved or cached by command buffers when the snapshot was written are freed
+                for (EntityIndex i = 0; i < counter; i++) {
+                    const Entity &slot = m_entities[i];
+
+                    if (!slot.isActive && slot.prev_free == NULL_INDEX && m_free_head != i)
+                        releaseIndex(i);
+                }
+                m_created_log.clear();
+                m_deleted_log.clear();
+                m_hierarchy_sorted = false;
+                registry.loadSnapshot(reader);
+            }
+
+            /**
+             * @brief Loads a snapshot file, mapped in memory rather than read through a stream
+             * 
+             * @param path The file's path
+             * @throw ERROR::SnapshotError => if the file can't be opened or the snapshot is rejected
+             */
+            void loadSnapshot(const std::string &path)
+            {
+                MappedFile file(path);
+
+                loadSnapshot(file.bytes());
+            }
+
+            /**
+             * @brief Appends what changed since the system's previous run, see writeDeltaSince()
+             * 
+             * @param out The buffer to append to, e.g. DeltaRing::push()
+             * @param sys The ID of the system taking the delta
+             */
+            void writeDelta(std::vector<std::byte> &out, SystemID sys)
+            {
+                writeDeltaSince(out, sys < m_systems.size() ? m_systems[sys].last_run : 0);
+            }
+
+            /**
+             * @brief Appends a compact delta: the entities created and deleted after a tick, then for each pool
+             * the components written after it (as raw bytes) and the removals
+             * 
+             * Only tracked writes are included, see entityMarkChanged(). Components that aren't trivially
+             * copyable are left out. Group changes of existing entities aren't carried.
+             * The events older than the oldest system run are dropped at the end of Update(),
+             * deltas from outside of systems only see what happened since.
+             * 
+             * @param out The buffer to append to
+             * @param since The tick the receiver is up to date with
+             * @throw ERROR::SnapshotError => with StorageMode::ARCHETYPE, which doesn't track changes
+             */
+            void writeDeltaSince(std::vector<std::byte> &out, uint32_t since)
+            {
+                SnapshotWriter writer(out);
+                std::size_t created = 0;
+
+                writer.value<uint32_t>(DELTA_MAGIC);
+                writer.value<uint32_t>(SNAPSHOT_VERSION);
+                writer.value<uint32_t>(since);
+                writer.value<uint32_t>(registry.changeTick());
+
+                auto deleted = logSince(m_deleted_log, since);
+
+                writer.value<uint64_t>(static_cast<uint64_t>(m_deleted_log.end() - deleted));
+                for (auto it = deleted; it != m_deleted_log.end(); it++)
+                    writer.value<EntityID>(it->entity);
+
+                // Entities deleted since are left out, the receiver never sees them
+                for (auto it = logSince(m_created_log, since); it != m_created_log.end(); it++)
+                    created += entityIsActive(it->entity);
+                writer.value<uint64_t>(created);
+                for (auto it = logSince(m_created_log, since); it != m_created_log.end(); it++) {
+                    if (!entityIsActive(it->entity))
+                        continue;
+                    writer.value<EntityID>(it->entity);
+                    writer.value<uint32_t>(static_cast<uint32_t>(m_entities[entityIndex(it->entity)].group));
+                }
+                registry.writeDelta(writer, since);
+            }
+
+            /**
+             * @brief Applies a delta written by another world with the same registered components
+             * 
+             * Deletions apply first, then creations with the exact same IDs, then each pool's removals
+             * and written components in one batch per pool. Applied writes count as changes of this world.
+             * 
+             * @param delta The delta
+             * @throw ERROR::SnapshotError => if the delta is truncated or corrupted, from another version or doesn't match the registered components
+             */
+            void applyDelta(std::span<const std::byte> delta)
+            {
+                SnapshotReader reader(delta);
+
+                if (reader.value<uint32_t>() != DELTA_MAGIC || reader.value<uint32_t>() != SNAPSHOT_VERSION)
+                    throw ERROR::SnapshotError("not a delta of this version");
+                reader.value<uint32_t>();
+                reader.value<uint32_t>();
+                {
+                    // Adopted IDs may be cached by a command buffer
+                    std::lock_guard<std::mutex> lock(m_command_mutex);
+
+                    releaseIdCaches();
+                }
+
+                std::size_t deleted = reader.blockSize<EntityID>();
+
+                for (std::size_t i = 0; i < deleted; i++)
+                    entityDelete(reader.value<EntityID>());
+
+                std::size_t created = reader.blockSize(sizeof(EntityID) + sizeof(uint32_t));
+
+                for (std::size_t i = 0; i < created; i++) {
+                    EntityID e = reader.value<EntityID>();
+
+                    uint32_t group = reader.value<uint32_t>();
+
+                    if (entityIndex(e) >= ENTITY_INDEX_LIMIT)
+                        throw ERROR::SnapshotError("corrupted entity ID");
+                    if (group >= ENTITY_GROUP_LIMIT)
+                        throw ERROR::SnapshotError("corrupted entity group");
+                    adoptEntity(e, static_cast<EntityGroup>(group));
+                }
+                m_hierarchy_sorted = false;
+                registry.applyDelta(reader);
+            }
+
+            /**
+             * @brief Applies the changes recorded in every command buffer
+             * 
+             * Entities are created first, then components are added and removed: each pool grows once
+             * and receives its commands sorted by entity. Entities are deleted last.
+             * The buffers' ID caches are then refilled, so that buffers used outside of Update() recycle IDs too.
+             * Must not be called while systems are running, nor while other threads record commands.
+             * 
+             * @throw ERROR::UnregisteredComponent => if a command targets an unregistered component, the buffers are cleared anyway
+             */
+            void flushCommands()
+            {
+                std::lock_guard<std::mutex> lock(m_command_mutex);
+
+                try {
+                    applyCommands();
+                } catch (...) {
+                    for (auto &it : m_command_buffers)
+                        it.second->clear();
+                    drainIdCaches();
+                    throw;
+                }
+                for (auto &it : m_command_buffers)
+                    it.second->clear();
+                drainIdCaches();
+                fillIdCaches();
             }
 
             Registry registry;
         private:
-            EntityID m_id_counter = 0;
-            std::queue<EntityID> m_available_ids;
-            std::size_t m_active_entities = 0;
-            std::vector<Entity> m_entities;
-            std::vector<SystemData> m_systems;
-    };
+            // A creation or deletion, see writeDelta()
+            struct EntityEvent {
+                EntityID entity;
+                uint32_t tick;
+            };
+
+            friend class CommandBuffer;
+            template<PipelineSystem... Systems>
+            friend class SystemPipeline;
+
+            /**
+             * @brief Removes an entity from its parent's children
+             */
+            void detachFromParent(ComponentPool<Relationship> &links, EntityID e)
+            {
+                Relationship &node = links.markChanged(e);
+
+                if (node.parent == NULL_ENTITY)
+                    return;
+
+                Relationship &parent = links.markChanged(node.parent);
+
+                if (node.prev_sibling != NULL_ENTITY)
+                    links.markChanged(node.prev_sibling).next_sibling = node.next_sibling;
+                else
+                    parent.first_child = node.next_sibling;
+                if (node.next_sibling != NULL_ENTITY)
+                    links.markChanged(node.next_sibling).prev_sibling = node.prev_sibling;
+                else
+                    parent.last_child = node.prev_sibling;
+                parent.children--;
+                node.parent = NULL_ENTITY;
+                node.prev_sibling = NULL_ENTITY;
+                node.next_sibling = NULL_ENTITY;
+                m_hierarchy_sorted = false;
+            }
+
+            /**
+             * @brief Takes an entity about to be deleted out of the hierarchy, its children become roots
+             */
+            void unlinkRelationship(EntityID e)
+            {
+                ComponentPool<Relationship> &links = registry.getPool<Relationship>();
+
+                detachFromParent(links, e);
+
+                Relationship &node = links.getComponent(e);
+
+                for (EntityID it = node.first_child; it != NULL_ENTITY;) {
+                    Relationship &child = links.markChanged(it);
+
+                    it = child.next_sibling;
+                    child.parent = NULL_ENTITY;
+                    child.prev_sibling = NULL_ENTITY;
+                    child.next_sibling = NULL_ENTITY;
+                }
+                node.first_child = NULL_ENTITY;
+                node.last_child = NULL_ENTITY;
+                node.children = 0;
+                m_hierarchy_sorted = false;
+            }
+
+            /**
+             * @brief Appends an entity and its descendants, depth-first, without recursion
+             */
+            static void collectSubtree(ComponentPool<Relationship> &links, EntityID root, std::vector<EntityID> &out)
+            {
+                EntityID it = root;
+
+                while (true) {
+                    out.push_back(it);
+
+                    const Relationship &node = links.getComponent(it);
+
+                    if (node.first_child != NULL_ENTITY) {
+                        it = node.first_child;
+                        continue;
+                    }
+                    // Climbs up to the first ancestor with a next sibling, stopping at the root
+                    while (it != root && links.getComponent(it).next_sibling == NULL_ENTITY)
+                        it = links.getComponent(it).parent;
+                    if (it == root)
+                        return;
+                    it = links.getComponent(it).next_sibling;
+                }
+            }
+
+            /**
+             * @brief Maps each cell of the sorted Relationship pool to the cell of its entity in a pool
+             * aligned to it, only comparing entity IDs
+             * 
+             * @return true If the pool is aligned, m_hierarchy_cells is filled then
+             * @return false If an entity of the hierarchy has its component out of place
+             */
+            template<ComponentType T>
+            bool matchHierarchy(ComponentPool<Relationship> &links, ComponentPool<T> &pool)
+            {
+                std::size_t next = 0;
+
+                m_hierarchy_cells.resize(links.size());
+                for (std::size_t i = 0; i < links.size(); i++) {
+                    if (next < pool.size() && pool.entityAt(next) == links.entityAt(i))
+                        m_hierarchy_cells[i] = static_cast<uint32_t>(next++);
+                    else
+                        m_hierarchy_cells[i] = NULL_INDEX;
+                }
+                // The unmatched cells must all belong to entities outside of the hierarchy
+                for (std::size_t i = next; i < pool.size(); i++) {
+                    EntityID e = pool.entityAt(i);
+
+                    if (e != NULL_ENTITY && links.hasComponent(e))
+                        return false;
+                }
+                return true;
+            }
+
+            /**
+             * @brief Runs the next step of the compaction round, see compactStep()
+             * 
+             * @param budget Free IDs the entity table step drops at most, 0 = no limit
+             */
+            bool compactNext(std::size_t budget)
+            {
+                std::size_t step = m_compact_cursor;
+
+                if (step == 0) {
+                    {
+                        // IDs cached by command buffers can be dropped too
+                        std::lock_guard<std::mutex> lock(m_command_mutex);
+
+                        releaseIdCaches();
+                    }
+                    // The entity table takes as many steps as its budget requires
+                    if (trimEntityTable(m_compact_policy.utilization, budget))
+                        m_compact_cursor = 1;
+                } else if (step <= registry.slotCount()) {
+                    registry.shrinkPool(step - 1, m_compact_policy.utilization);
+                    m_compact_cursor++;
+                } else {
+                    registry.shrinkArchetypes(m_id_counter.load(std::memory_order_relaxed), m_compact_policy.utilization);
+                    m_compact_cursor = 0;
+                    return true;
+                }
+                return false;
+            }
+
+            /**
+             * @brief Drops the free IDs past the last used one, then shrinks the table under a utilization
+             * 
+             * IDs reserved by command buffers aren't in the free list, they stop the trim,
+             * as do the indices past the table, reserved and not published yet.
+             * 
+             * @param utilization The fraction of the capacity under which the table is shrunk
+             * @param budget Free IDs dropped at most, 0 = no limit
+             * @return true If the trim is complete
+             * @return false If the budget ran out first, the table isn't shrunk yet
+             */
+            bool trimEntityTable(float utilization, std::size_t budget)
+            {
+                EntityIndex end = m_id_counter.load(std::memory_order_relaxed);
+
+                for (std::size_t dropped = 0; end != 0 && end <= m_entities.size(); dropped++) {
+                    Entity &slot = m_entities[end - 1];
+
+                    if (slot.isActive || (slot.prev_free == NULL_INDEX && m_free_head != end - 1))
+                        break;
+                    if (budget != 0 && dropped == budget) {
+                        m_id_counter.store(end, std::memory_order_relaxed);
+                        return false;
+                    }
+                    // Stale handles of this index are of an older generation, see reserveFreshEntity()
+                    m_fresh_generation = std::max(m_fresh_generation, slot.generation);
+                    unlinkFree(end - 1);
+                    slot = Entity();
+                    end--;
+                }
+                m_id_counter.store(end, std::memory_order_relaxed);
+
+                std::size_t size = std::max<std::size_t>(std::min<std::size_t>(end, m_entities.size()), 32);
+
+                if (static_cast<float>(size) < static_cast<float>(m_entities.capacity()) * utilization) {
+                    m_entities.resize(size);
+                    m_entities.shrink_to_fit();
+                }
+                for (auto &members : m_groups) {
+                    if (static_cast<float>(members.size()) < static_cast<float>(members.capacity()) * utilization)
+                        members.shrink_to_fit();
+                }
+                m_created_log.shrink_to_fit();
+                m_deleted_log.shrink_to_fit();
+                return true;
+            }
+
+            /**
+             * @brief Takes an unused entity ID without activating it, recycling freed slots first
+             * 
+             * The free list isn't synchronized, only the thread making structural changes calls this.
+             * Other threads reserve through their command buffer, see CommandBuffer::entityCreate().
+             * 
+             * @return EntityID The reserved ID
+             */
+            EntityID reserveEntity()
+            {
+                EntityIndex index = m_free_head;
+
+                if (index != NULL_INDEX) {
+                    Entity &slot = m_entities[index];
+
+                    unlinkFree(index);
+                    return makeEntityID(index, slot.generation);
+                }
+                return reserveFreshEntity();
+            }
+
+            /**
+             * @brief Takes a never used entity index, lock-free and safe to call from any thread
+             * 
+             * @return EntityID The reserved ID, of the generation fresh indices start at, see compact()
+             * @throw ERROR::EntityLimitReached => if every entity index is in use
+             */
+            EntityID reserveFreshEntity()
+            {
+                EntityIndex index = m_id_counter.load(std::memory_order_relaxed);
+
+                do {
+                    if (index >= ENTITY_INDEX_LIMIT)
+                        throw ERROR::EntityLimitReached(ENTITY_INDEX_LIMIT);
+                } while (!m_id_counter.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+                return makeEntityID(index, m_fresh_generation);
+            }
+
+            /**
+             * @brief Hands freed slots to the command buffers before the systems run, so that their
+             * reservations recycle IDs without touching the free list
+             * 
+             * Each buffer gets as many IDs as it reserved in the busier of its last two flush intervals, up to ID_CACHE_LIMIT,
+             * so that flushes taking turns between creations and deletions still recycle. m_command_mutex must be held.
+             */
+            void fillIdCaches()
+            {
+                for (auto &[thread, buffer] : m_command_buffers) {
+                    std::size_t wanted = std::min(std::max(buffer->m_reserved_last, buffer->m_reserved_before), ID_CACHE_LIMIT);
+
+                    while (buffer->m_free_ids.size() < wanted && m_free_head != NULL_INDEX) {
+                        EntityIndex index = m_free_head;
+
+                        unlinkFree(index);
+                        buffer->m_free_ids.push_back(makeEntityID(index, m_entities[index].generation));
+                    }
+                }
+            }
+
+            /**
+             * @brief Puts the IDs the command buffers didn't use back in the free list and moves their
+             * reservation counts on, see fillIdCaches()
+             */
+            void drainIdCaches()
+            {
+                releaseIdCaches();
+                for (auto &[thread, buffer] : m_command_buffers) {
+                    buffer->m_reserved_before = buffer->m_reserved_last;
+                    buffer->m_reserved_last = buffer->m_reserved;
+                    buffer->m_reserved = 0;
+                }
+            }
+
+            /**
+             * @brief Puts the IDs cached by the command buffers back in the free list, m_command_mutex must be held
+             * 
+             * Called before the free list must hold every unused ID, see compact() and applyDelta()
+             */
+            void releaseIdCaches()
+            {
+                for (auto &[thread, buffer] : m_command_buffers) {
+                    for (EntityID e : buffer->m_free_ids)
+                        releaseIndex(entityIndex(e));
+                    buffer->m_free_ids.clear();
+                }
+            }
+
+            /**
+             * @brief Appends a slot to the free list, slots are reused in the order they were freed
+             * 
+             * @param index The slot's index
+             */
+            void releaseIndex(EntityIndex index)
+            {
+                if (m_free_tail == NULL_INDEX)
+                    m_free_head = index;
+                else
+                    m_entities[m_free_tail].next_free = index;
+                m_entities[index].prev_free = m_free_tail;
+                m_free_tail = index;
+            }
+
+            /**
+             * @brief Takes a slot out of the free list, in O(1)
+             */
+            void unlinkFree(EntityIndex index)
+            {
+                Entity &slot = m_entities[index];
+
+                if (slot.prev_free == NULL_INDEX)
+                    m_free_head = slot.next_free;
+                else
+                    m_entities[slot.prev_free].next_free = slot.next_free;
+                if (slot.next_free == NULL_INDEX)
+                    m_free_tail = slot.prev_free;
+                else
+                    m_entities[slot.next_free].prev_free = slot.prev_free;
+                slot.next_free = NULL_INDEX;
+                slot.prev_free = NULL_INDEX;
+            }
+
+            /**
+             * @brief Checks a loaded entity table against itself, its free list and its groups, see loadSnapshot()
+             * 
+             * Every slot holds a valid active flag and generation, inactive slots have no group slot nor component,
+             * every active slot is the member of its group it claims to be, the free list runs from head to tail
+             * over inactive slots only, and the slots outside of it aren't linked. The pools check the signatures.
+             * 
+             * @throw ERROR::SnapshotError => on the first inconsistency
+             */
+            static void checkSnapshotTable(std::span<const Entity> table, EntityIndex counter, EntityIndex free_head, EntityIndex free_tail,
+                const std::vector<std::vector<EntityID>> &groups, uint64_t active)
+            {
+                std::size_t members = 0;
+                std::size_t found = 0;
+
+                for (const auto &group : groups)
+                    members += group.size();
+                for (EntityIndex i = 0; i < table.size(); i++) {
+                    const Entity &slot = table[i];
+                    unsigned char flag;
+                    std::underlying_type_t<EntityGroup> group;
+
+                    // Read as raw bytes, a corrupted bool or enum can't be loaded as such
+                    std::memcpy(&flag, &slot.isActive, sizeof(flag));
+                    std::memcpy(&group, &slot.group, sizeof(group));
+                    if (flag > 1 || slot.generation > ENTITY_GENERATION_MASK
+                        || static_cast<std::size_t>(group) >= std::max<std::size_t>(groups.size(), 1))
+                        throw ERROR::SnapshotError("corrupted entity table");
+                    if ((slot.next_free != NULL_INDEX && slot.next_free >= counter) || (slot.prev_free != NULL_INDEX && slot.prev_free >= counter))
+                        throw ERROR::SnapshotError("corrupted free list");
+                    if (flag == 0) {
+                        if (slot.group_slot != NULL_INDEX || !slot.components.none())
+                            throw ERROR::SnapshotError("corrupted entity table");
+                        continue;
+                    }
+                    if (i >= counter || static_cast<std::size_t>(group) >= groups.size() || slot.group_slot >= groups[group].size() || groups[group][slot.group_slot] != makeEntityID(i, slot.generation))
+                        throw ERROR::SnapshotError("corrupted groups");
+                    found++;
+                }
+                if (found != active || members != active)
+                    throw ERROR::SnapshotError("corrupted groups");
+                if ((free_head == NULL_INDEX) != (free_tail == NULL_INDEX)
+                    || (free_head != NULL_INDEX && (free_head >= counter || free_tail >= counter)))
+                    throw ERROR::SnapshotError("corrupted free list");
+
+                std::vector<bool> listed(table.size(), false);
+                EntityIndex previous = NULL_INDEX;
+
+                for (EntityIndex it = free_head; it != NULL_INDEX; it = table[it].next_free) {
+                    if (listed[it] || table[it].isActive || table[it].prev_free != previous)
+                        throw ERROR::SnapshotError("corrupted free list");
+                    listed[it] = true;
+                    previous = it;
+                }
+                if (previous != free_tail)
+                    throw ERROR::SnapshotError("corrupted free list");
+                for (EntityIndex i = 0; i < table.size(); i++) {
+                    if (!listed[i] && (table[i].next_free != NULL_INDEX || table[i].prev_free != NULL_INDEX))
+                        throw ERROR::SnapshotError("corrupted free list");
+                }
+            }
+
+            /**
+             * @brief Marks an entity ID as active, growing the entity table if needed
+             * 
+             * @param e The entity ID, either fresh or reserved
+             * @param group The entity's group
+             */
+            void publishEntity(EntityID e, EntityGroup group)
+            {
+                EntityIndex index = entityIndex(e);
+
+                growTable(index);
+                m_entities[index].isActive = true;
+                m_entities[index].generation = entityGeneration(e);
+                groupInsert(index, group);
+                m_created_log.push_back(EntityEvent{e, registry.changeTick()});
+                BLOB_ECS_COUNT(ENTITY_CREATES, 1);
+                m_active_entities++;
+            }
+
+            /**
+             * @brief Grows the entity table so that it covers an index
+             */
+            void growTable(EntityIndex index)
+            {
+                if (index >= m_entities.size()) {
+                    std::size_t new_size = m_entities.size();
+
+                    while (new_size <= index)
+                        new_size <<= 1;
+                    m_entities.resize(new_size);
+                }
+            }
+
+            /**
+             * @brief Activates an entity with the exact ID it has in another world, see applyDelta()
+             * 
+             * @param e The entity ID, an entity holding its slot with another generation is deleted
+             * @param group The entity's group
+             */
+            void adoptEntity(EntityID e, EntityGroup group)
+            {
+                EntityIndex index = entityIndex(e);
+
+                if (entityIsActive(e)) {
+                    entitySetGroup(e, group);
+                    return;
+                }
+                growTable(index);
+                EntityIndex counter = m_id_counter.load(std::memory_order_relaxed);
+
+                if (index < counter && m_entities[index].isActive)
+                    entityDelete(makeEntityID(index, m_entities[index].generation));
+                if (index >= counter) {
+                    // The skipped slots become free ones
+                    for (EntityIndex i = counter; i < index; i++)
+                        releaseIndex(i);
+                    m_id_counter.store(index + 1, std::memory_order_relaxed);
+                } else if (m_entities[index].prev_free != NULL_INDEX || m_free_head == index) {
+                    unlinkFree(index);
+                }
+                publishEntity(e, group);
+            }
+
+            std::vector<EntityID> &groupMembers(EntityGroup group)
+            {
+                if (static_cast<std::size_t>(group) >= m_groups.size())
+                    m_groups.resize(static_cast<std::size_t>(group) + 1);
+                return m_groups[group];
+            }
+
+            void groupReserve(EntityGroup group, std::size_t count)
+            {
+                std::vector<EntityID> &members = groupMembers(group);
+
+                members.reserve(members.size() + count);
+            }
+
+            /**
+             * @brief Appends an active entity to a group's member list
+             */
+            void groupInsert(EntityIndex index, EntityGroup group)
+            {
+                std::vector<EntityID> &members = groupMembers(group);
+                Entity &slot = m_entities[index];
+
+                slot.group = group;
+                slot.group_slot = static_cast<uint32_t>(members.size());
+                members.push_back(makeEntityID(index, slot.generation));
+            }
+
+            /**
+             * @brief Removes an active entity from its group's member list, the last member takes its place
+             */
+            void groupErase(EntityIndex index)
+            {
+                std::vector<EntityID> &members = m_groups[m_entities[index].group];
+                uint32_t position = m_entities[index].group_slot;
+
+                if (position != members.size() - 1) {
+                    members[position] = members.back();
+                    m_entities[entityIndex(members[position])].group_slot = position;
+                }
+                members.pop_back();
+                m_entities[index].group_slot = NULL_INDEX;
+            }
+
+            void applyCommands()
+            {
+                for (auto &[thread, buffer] : m_command_buffers) {
+                    for (const auto &it : buffer->m_created)
+                        publishEntity(it.entity, it.group);
+                }
+
+                m_flush_types.clear();
+                for (auto &[thread, buffer] : m_command_buffers) {
+                    for (uint16_t type : buffer->m_types) {
+                        if (!buffer->m_components[type]->empty())
+                            m_flush_types.push_back(type);
+                    }
+                }
+                std::sort(m_flush_types.begin(), m_flush_types.end());
+                m_flush_types.erase(std::unique(m_flush_types.begin(), m_flush_types.end()), m_flush_types.end());
+                for (uint16_t type : m_flush_types) {
+                    m_flush_lists.clear();
+                    for (auto &[thread, buffer] : m_command_buffers) {
+                        if (type < buffer->m_components.size() && buffer->m_components[type] && !buffer->m_components[type]->empty())
+                            m_flush_lists.push_back(buffer->m_components[type].get());
+                    }
+                    m_flush_lists.front()->apply(registry, m_entities, m_flush_lists);
+                }
+
+                m_flush_deleted.clear();
+                for (auto &[thread, buffer] : m_command_buffers)
+                    m_flush_deleted.insert(m_flush_deleted.end(), buffer->m_deleted.begin(), buffer->m_deleted.end());
+                std::sort(m_flush_deleted.begin(), m_flush_deleted.end());
+                m_flush_deleted.erase(std::unique(m_flush_deleted.begin(), m_flush_deleted.end()), m_flush_deleted.end());
+                for (EntityID e : m_flush_deleted)
+                    entityDelete(e);
+            }
+
+            /**
+             * @brief Advances the tick counter or the fixed timestep accumulator of a system
+             * 
+             * @param data The system
+             * @param msecs The time elapsed since the previous Update()
+             * @return uint32_t The amount of times the system should be updated this tick
+             */
+            static uint32_t tickSystem(SystemData &data, uint32_t msecs)
+            {
+                if (!data.enabled)
+                    return 0;
+                if (data.period != 0) {
+                    uint32_t steps = (data.accumulator + msecs) / data.period;
+
+                    data.accumulator = (data.accumulator + msecs) % data.period;
+                    // Falling behind, catching up would only make the next frames slower
+                    return std::min(steps, data.max_steps);
+                }
+                if (data.skipped_ticks >= data.tickrate) {
+                    data.skipped_ticks = 0;
+                    return 1;
+                }
+                data.skipped_ticks++;
+                return 0;
+            }
+
+            /**
+             * @brief Starts the time budget of a system's run, see systemBudgetExhausted()
+             */
+            static void startBudget(SystemData &data)
+            {
+                if (data.budget.count() != 0)
+                    data.deadline = std::chrono::steady_clock::now() + data.budget;
+            }
+
+            /**
+             * @brief Checks if two systems can't run at the same time
+             */
+            static bool systemsConflict(const SystemData &a, const SystemData &b)
+            {
+                auto intersects = [](const std::vector<uint16_t> &x, const std::vector<uint16_t> &y) {
+                    return std::find_first_of(x.begin(), x.end(), y.begin(), y.end()) != x.end();
+                };
+
+                if (a.exclusive || b.exclusive)
+                    return true;
+                return intersects(a.writes, b.writes) || intersects(a.writes, b.reads) || intersects(a.reads, b.writes);
+            }
+
+            /**
+             * @brief Splits the systems in stages, a system is placed right after the last stage
+             * holding a system it conflicts with, so conflicting systems keep their registration order
+             */
+            void buildSchedule()
+            {
+                std::vector<std::size_t> stage_of(m_systems.size(), 0);
+
+                m_stages.clear();
+                for (std::size_t i = 0; i < m_systems.size(); i++) {
+                    for (std::size_t j = 0; j < i; j++) {
+                        if (stage_of[j] >= stage_of[i] && systemsConflict(m_systems[i], m_systems[j]))
+                            stage_of[i] = stage_of[j] + 1;
+                    }
+                    if (stage_of[i] >= m_stages.size())
+                        m_stages.resize(stage_of[i] + 1);
+                    m_stages[stage_of[i]].push_back(static_cast<SystemID>(i));
+                }
+                m_schedule_dirty = false;
+            }
+
+            /**
+             * @brief Runs a system as many times as it is due, each run at a new change tick, see tickSystem()
+             * 
+             * @param id The system's ID
+             * @param msecs The time elapsed since the previous Update()
+             * @param update Calls the system's Update() with the msecs of the run
+             */
+            template<typename Func>
+            void runSystem(SystemID id, uint32_t msecs, Func &&update)
+            {
+                SystemData &data = m_systems[id];
+                uint32_t steps = tickSystem(data, msecs);
+
+                for (uint32_t step = 0; step < steps; step++) {
+                    uint32_t tick = registry.advanceChangeTick();
+
+                    startBudget(data);
+                    timeSystem(id, [&]() { update(data.period != 0 ? data.period : msecs); });
+                    data.last_run = tick;
+                }
+            }
+
+            uint32_t stepMsecs(SystemID id, uint32_t msecs) const
+            {
+                return m_systems[id].period != 0 ? m_systems[id].period : msecs;
+            }
+
+            /**
+             * @brief Calls the Update() of a system, whether it was added alone or in a pipeline
+             */
+            void callSystem(SystemID id, uint32_t msecs)
+            {
+                SystemData &data = m_systems[id];
+
+                timeSystem(id, [&]() {
+                    if (data.pipeline != nullptr)
+                        data.pipeline->UpdateOne(*this, id - static_cast<SystemID>(data.pipeline_index), data.pipeline_index, msecs);
+                    else
+                        data.sys->Update(*this, id, msecs);
+                });
+            }
+
+            /**
+             * @brief Calls fn, recording how long it took as a run of the system when profiling is enabled
+             */
+            template<typename Func>
+            void timeSystem([[maybe_unused]] SystemID id, Func &&fn)
+            {
+#ifdef BLOB_ECS_PROFILING
+                auto begin = std::chrono::steady_clock::now();
+
+                fn();
+                m_profiler.record(id, begin, std::chrono::steady_clock::now());
+#else
+                fn();
+#endif
+            }
+
+            /**
+             * @brief Runs the systems stage by stage on the thread pool
+             */
+            void updateParallel(uint32_t msecs)
+            {
+                if (m_schedule_dirty)
+                    buildSchedule();
+                for (const auto &stage : m_stages) {
+                    uint32_t rounds = 0;
+
+                    m_stage_steps.clear();
+                    for (SystemID i : stage) {
+                        m_stage_steps.push_back(tickSystem(m_systems[i], msecs));
+                        rounds = std::max(rounds, m_stage_steps.back());
+                    }
+
+                    // Fixed timestep systems that are due several times run again in the next rounds
+                    for (uint32_t round = 0; round < rounds; round++) {
+                        m_ready_systems.clear();
+                        for (std::size_t i = 0; i < stage.size(); i++) {
+                            if (m_stage_steps[i] > round)
+                                m_ready_systems.push_back(stage[i]);
+                        }
+
+                        // Systems may read the entity caches concurrently, they must not be rebuilt lazily
+                        registry.syncCaches();
+                        uint32_t tick = registry.advanceChangeTick();
+
+                        for (SystemID i : m_ready_systems)
+                            startBudget(m_systems[i]);
+                        if (m_ready_systems.size() == 1) {
+                            callSystem(m_ready_systems[0], stepMsecs(m_ready_systems[0], msecs));
+                        } else {
+                            TaskGroup group;
+                            for (SystemID i : m_ready_systems)
+                                m_thread_pool->run(group, [this, i, msecs]() { callSystem(i, stepMsecs(i, msecs)); });
+                            m_thread_pool->wait(group);
+                        }
+                        for (SystemID i : m_ready_systems)
+                            m_systems[i].last_run = tick;
+                    }
+                }
+            }
+
+            /**
+             * @brief Drops the removals every enabled system has seen, see ComponentPool::removedSince()
+             */
+            void trimRemovals()
+            {
+                uint32_t oldest = registry.changeTick();
+
+                for (const SystemData &it : m_systems) {
+                    if (it.enabled && tickIsNewer(oldest, it.last_run))
+                        oldest = it.last_run;
+                }
+                registry.trimRemoved(oldest);
+                trimLog(m_created_log, oldest);
+                trimLog(m_deleted_log, oldest);
+            }
+
+            /**
+             * @brief Get the first event of a log stamped after a tick
+             */
+            static std::vector<EntityEvent>::const_iterator logSince(const std::vector<EntityEvent> &log, uint32_t tick)
+            {
+                return std::partition_point(log.begin(), log.end(), [tick](const EntityEvent &it) { return !tickIsNewer(it.tick, tick); });
+            }
+
+            static void trimLog(std::vector<EntityEvent> &log, uint32_t tick)
+            {
+                log.erase(log.begin(), logSince(log, tick));
+            }
+
+            // Recycled IDs a command buffer keeps at most between two flushes
+            static constexpr std::size_t ID_CACHE_LIMIT = 1024;
+
+            std::atomic<EntityIndex> m_id_counter = 0;                  // Next never used index, reserved lock-free
+            uint32_t m_fresh_generation = 0;                            // Generation of fresh IDs, above every dropped one, see compact()
+            CompactPolicy m_compact_policy;
+            uint32_t m_compact_countdown = 0;                           // Update() calls since the last compaction step
+            std::size_t m_compact_cursor = 0;                           // Next step of the compaction round, see compactStep()
+            EntityIndex m_free_head = NULL_INDEX;                       // Free list threaded through Entity::next_free
+            EntityIndex m_free_tail = NULL_INDEX;
+            std::size_t m_active_entities = 0;
+            std::vector<Entity> m_entities;
+            std::vector<std::vector<EntityID>> m_groups;                // Members of each group, indexed by EntityGroup
+            std::vector<EntityID> m_hierarchy_order;                     // Scratch list of the hierarchy's entities, depth-first
+            std::vector<uint32_t> m_hierarchy_parents;                  // Cell of each cell's parent in the sorted Relationship pool
+            std::vector<uint32_t> m_hierarchy_cells;                    // Cell of each cell's entity in the propagated pool
+            bool m_hierarchy_sorted = false;                            // The Relationship pool is depth-first, see sortHierarchy()
+            std::vector<EntityEvent> m_created_log;                     // Creations not seen by every system yet, see writeDelta()
+            std::vector<EntityEvent> m_deleted_log;
+            std::vector<SystemData> m_systems;
+            std::vector<std::unique_ptr<ISystemPipeline>> m_pipelines;
+#ifdef BLOB_ECS_PROFILING
+            SystemProfiler m_profiler;
+#endif
+            ThreadPool *m_thread_pool = nullptr;
+            bool m_schedule_dirty = false;
+            std::vector<std::vector<SystemID>> m_stages;            // Systems that can run together, in execution order
+            std::vector<SystemID> m_ready_systems;
+            std::vector<uint32_t> m_stage_steps;                    // Runs due for each system of the current stage
+
+            inline static std::atomic<uint64_t> s_world_counter = 0;
+            uint64_t m_world_uid = ++s_world_counter;                   // Never reused, keys the thread-local buffer cache
+            std::mutex m_command_mutex;
+            std::vector<std::pair<std::thread::id, std::unique_ptr<CommandBuffer>>> m_command_buffers;
+            std::vector<uint16_t> m_flush_types;
+            std::vector<IComponentCommands *> m_flush_lists;
+            std::vector<EntityID> m_flush_deleted;
+    };
+
+    template<PipelineSystem... Systems>
+    void SystemPipeline<Systems...>::Update(ECS &ecs, SystemID first, uint32_t msecs)
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (ecs.runSystem(static_cast<SystemID>(first + I), msecs, [&](uint32_t step_msecs) {
+                call<I>(ecs, static_cast<SystemID>(first + I), step_msecs);
+            }), ...);
+        }(std::index_sequence_for<Systems...>{});
+    }
+
+    template<PipelineSystem... Systems>
+    void SystemPipeline<Systems...>::UpdateOne(ECS &ecs, SystemID first, std::size_t index, uint32_t msecs)
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((index == I ? call<I>(ecs, static_cast<SystemID>(first + I), msecs) : void()), ...);
+        }(std::index_sequence_for<Systems...>{});
+    }
+
+    inline EntityID CommandBuffer::entityCreate(EntityGroup group)
+    {
+        EntityID e;
+
+        if (!m_free_ids.empty()) {
+            e = m_free_ids.back();
+            m_free_ids.pop_back();
+        } else {
+            e = m_world.reserveFreshEntity();
+        }
+        m_reserved++;
+
+        m_created.push_back(Creation{e, group});
+        return e;
+    }
 }
 
 #endif /* !ECS_HPP_ */
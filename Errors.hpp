@@ -87,6 +87,96 @@ namespace ECS {
             private:
                 std::string message;
         };
+
+        class TooManyComponents : public std::exception {
+            public:
+                TooManyComponents(const std::string& compname, std::size_t limit)
+                : message("Component '" + compname + "' can't be registered, the limit of " + std::to_string(limit) + " component types is reached!")
+                {}
+                ~TooManyComponents() {}
+
+                const char *what() const noexcept override
+                {
+                    return message.c_str();
+                }
+            private:
+                std::string message;
+        };
+
+        class NoComponentPool : public std::exception {
+            public:
+                NoComponentPool(const std::string& compname)
+                : message("Component '" + compname + "' has no pool, the world uses archetype storage!")
+                {}
+                ~NoComponentPool() {}
+
+                const char *what() const noexcept override
+                {
+                    return message.c_str();
+                }
+            private:
+                std::string message;
+        };
+
+        class EntityLimitReached : public std::exception {
+            public:
+                EntityLimitReached(std::size_t limit)
+                : message("Entity limit of " + std::to_string(limit) + " entities reached!")
+                {}
+                ~EntityLimitReached() {}
+
+                const char *what() const noexcept override
+                {
+                    return message.c_str();
+                }
+            private:
+                std::string message;
+        };
+
+        class SnapshotError : public std::exception {
+            public:
+                SnapshotError(const std::string& reason)
+                : message("Invalid snapshot: " + reason + "!")
+                {}
+                ~SnapshotError() {}
+
+                const char *what() const noexcept override
+                {
+                    return message.c_str();
+                }
+            private:
+                std::string message;
+        };
+
+        class ComponentListMismatch : public std::exception {
+            public:
+                ComponentListMismatch(const std::string& component, std::size_t index, std::size_t slot)
+                : message("Component '" + component + "' is at index " + std::to_string(index) + " of its list but was registered in slot " + std::to_string(slot) + "!")
+                {}
+                ~ComponentListMismatch() {}
+
+                const char *what() const noexcept override
+                {
+                    return message.c_str();
+                }
+            private:
+                std::string message;
+        };
+
+        class HierarchyCycle : public std::exception {
+            public:
+                HierarchyCycle(std::size_t child, std::size_t parent)
+                : message("Entity id " + std::to_string(child) + " can't become a child of entity id " + std::to_string(parent) + ", one of its descendants!")
+                {}
+                ~HierarchyCycle() {}
+
+                const char *what() const noexcept override
+                {
+                    return message.c_str();
+                }
+            private:
+                std::string message;
+        };
     }
 }
 
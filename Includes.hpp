@@ -29,9 +29,17 @@
     #include <typeindex>
     #include <cstdint>
     #include <atomic>
+    #include <vector>
+    #include <span>
+    #include <limits>
+    #include <ranges>
+    #include <bit>
+    #include <memory>
+    #include <chrono>
 
 namespace ECS {
     class ISystem;
+    class ISystemPipeline;
     class ECS;
         
     // Concept for accepting system classes
@@ -42,33 +50,208 @@ namespace ECS {
     template<typename T>
     concept ComponentType = std::is_default_constructible_v<T>;
 
+    // Assumed cache line size, used to align parallel work on dense arrays
+    constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+#ifdef BLOB_ECS_64BIT_ENTITY
+    // Alias for uint64_t, used to represent, locate and perform actions on entities
+    using EntityID = uint64_t;
+
+    // Low bits of an EntityID holding the entity's index, the high bits hold its generation
+    constexpr unsigned int ENTITY_INDEX_BITS = 32;
+#else
     // Alias for uint32_t, used to represent, locate and perform actions on entities
     using EntityID = uint32_t;
 
+    #ifndef BLOB_ECS_ENTITY_INDEX_BITS
+        #define BLOB_ECS_ENTITY_INDEX_BITS 24
+    #endif
+    // Low bits of an EntityID holding the entity's index, the high bits hold its generation
+    constexpr unsigned int ENTITY_INDEX_BITS = BLOB_ECS_ENTITY_INDEX_BITS;
+    static_assert(ENTITY_INDEX_BITS > 0 && ENTITY_INDEX_BITS < 32, "BLOB_ECS_ENTITY_INDEX_BITS must be within [1, 31]");
+#endif
+
+    // Alias for uint32_t, the slot of an entity within the ECS and the key of the pools' sparse arrays
+    using EntityIndex = uint32_t;
+
+    constexpr uint32_t NULL_INDEX = std::numeric_limits<uint32_t>::max();
+    constexpr EntityID ENTITY_INDEX_MASK = (EntityID(1) << ENTITY_INDEX_BITS) - 1;
+    constexpr uint32_t ENTITY_GENERATION_MASK = static_cast<uint32_t>(std::numeric_limits<EntityID>::max() >> ENTITY_INDEX_BITS);
+
+    // Amount of usable entity indices, the top index is reserved so that no live handle equals NULL_ENTITY
+    // and, with 32-bit indices, no index equals NULL_INDEX
+    constexpr EntityIndex ENTITY_INDEX_LIMIT = static_cast<EntityIndex>(ENTITY_INDEX_MASK);
+
+    // Handle that never refers to an entity
+    constexpr EntityID NULL_ENTITY = std::numeric_limits<EntityID>::max();
+
+    /**
+     * @brief Compares change ticks, wrapping around is handled as long as both are less than 2^31 ticks apart
+     * 
+     * @param tick The stamped tick
+     * @param since The reference tick
+     * @return true If tick was stamped after since
+     * @return false otherwise
+     */
+    constexpr bool tickIsNewer(uint32_t tick, uint32_t since) {
+        return static_cast<int32_t>(tick - since) > 0;
+    }
+
+    // Contiguous range of entity handles, see ECS::entityCreateBulk()
+    using EntityRange = std::ranges::iota_view<EntityID, EntityID>;
+
+    /**
+     * @brief Returns the index part of an entity handle
+     */
+    constexpr EntityIndex entityIndex(EntityID e) {
+        return static_cast<EntityIndex>(e & ENTITY_INDEX_MASK);
+    }
+
+    /**
+     * @brief Returns the generation part of an entity handle, it changes every time the index is recycled
+     */
+    constexpr uint32_t entityGeneration(EntityID e) {
+        return static_cast<uint32_t>(e >> ENTITY_INDEX_BITS);
+    }
+
+    /**
+     * @brief Builds an entity handle from an index and a generation
+     */
+    constexpr EntityID makeEntityID(EntityIndex index, uint32_t generation) {
+        return (static_cast<EntityID>(generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | index;
+    }
+
     // Alias for uint16_t, used to represent a System within the ECS
     using SystemID = uint16_t;
 
+    #ifndef BLOB_ECS_MAX_COMPONENTS
+        #define BLOB_ECS_MAX_COMPONENTS 128
+    #endif
+    // Maximum amount of component types registered in a single ECS
+    constexpr std::size_t MAX_COMPONENTS = BLOB_ECS_MAX_COMPONENTS;
+    static_assert(MAX_COMPONENTS > 0 && MAX_COMPONENTS % 64 == 0, "BLOB_ECS_MAX_COMPONENTS must be a non-zero multiple of 64");
+
+    /**
+     * @brief Fixed-width set of component slots, bit i is set when the component registered i-th is present
+     */
+    struct ComponentMask {
+        static constexpr std::size_t WORDS = MAX_COMPONENTS / 64;
+
+        uint64_t words[WORDS] = {};
+
+        void set(std::size_t bit) { words[bit >> 6] |= uint64_t(1) << (bit & 63); }
+        void reset(std::size_t bit) { words[bit >> 6] &= ~(uint64_t(1) << (bit & 63)); }
+        bool test(std::size_t bit) const { return (words[bit >> 6] >> (bit & 63)) & 1; }
+        bool operator==(const ComponentMask &) const = default;
+
+        /**
+         * @brief Checks if every bit of other is set in this mask
+         */
+        bool containsAll(const ComponentMask &other) const {
+            uint64_t missing = 0;
+
+            for (std::size_t i = 0; i < WORDS; i++)
+                missing |= other.words[i] & ~words[i];
+            return missing == 0;
+        }
+
+        /**
+         * @brief Checks if at least one bit of other is set in this mask
+         */
+        bool intersects(const ComponentMask &other) const {
+            uint64_t common = 0;
+
+            for (std::size_t i = 0; i < WORDS; i++)
+                common |= other.words[i] & words[i];
+            return common != 0;
+        }
+
+        bool none() const {
+            uint64_t any = 0;
+
+            for (std::size_t i = 0; i < WORDS; i++)
+                any |= words[i];
+            return any == 0;
+        }
+
+        /**
+         * @brief Calls fn(bit) for each set bit, in increasing order
+         */
+        template<typename Func>
+        void forEach(Func &&fn) const {
+            for (std::size_t i = 0; i < WORDS; i++) {
+                for (uint64_t word = words[i]; word != 0; word &= word - 1)
+                    fn(i * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+            }
+        }
+    };
+
     // Entity groups, modify this enum to add new groups to the system
     enum EntityGroup {
         NONE,
         EXAMPLES
     };
 
+    // Groups a delta may create entities in, each group up to it gets a member list
+    constexpr uint32_t ENTITY_GROUP_LIMIT = 1 << 16;
+
     /*
         This is how an entity is stored within the ECS
         isActive represents if an entity exists or not
         group represents a group which the entity belongs to
+        generation is the generation of the handle currently owning the slot
+        next_free and prev_free link free slots together, in the order they'll be reused
+        group_slot is the position of the entity within its group's member list
+        components is the entity's signature, kept up to date by the component pools
     */
     struct Entity {
         bool isActive = false;
         EntityGroup group = NONE;
+        uint32_t generation = 0;
+        EntityIndex next_free = NULL_INDEX;
+        EntityIndex prev_free = NULL_INDEX;
+        uint32_t group_slot = NULL_INDEX;
+        ComponentMask components;
     };
 
+    /**
+     * @brief Checks if a handle refers to a live entity of an entity table, in O(1)
+     * 
+     * @param entities The entity table
+     * @param e The entity handle
+     * @return true If the slot is active and the handle's generation is the current one
+     */
+    inline bool entityIsAlive(std::span<const Entity> entities, EntityID e) {
+        EntityIndex index = entityIndex(e);
+
+        return index < entities.size() && entities[index].isActive && entities[index].generation == entityGeneration(e);
+    }
+
     struct SystemData {
         bool enabled;
-        ISystem *sys;
+        std::unique_ptr<ISystem> sys;   // nullptr for the systems of a pipeline
+        ISystemPipeline *pipeline = nullptr;
+        std::size_t pipeline_index = 0; // Position of the system within its pipeline
         int tickrate;
         int skipped_ticks;
+        bool exclusive;                 // No declared access, never runs alongside other systems
+        std::vector<uint16_t> reads;    // Component type IDs the system reads
+        std::vector<uint16_t> writes;   // Component type IDs the system writes
+        uint32_t last_run = 0;          // Change tick of the system's previous run, see ECS::view(SystemID)
+        uint32_t period = 0;            // Fixed timestep in msecs, 0 = once per due Update() (see tickrate)
+        uint32_t max_steps = 0;         // Fixed steps run at most per Update(), the rest of the backlog is dropped
+        uint32_t accumulator = 0;       // Msecs accumulated towards the next fixed step
+        std::chrono::nanoseconds budget{0};                 // Time a run may take, 0 = unlimited
+        std::chrono::steady_clock::time_point deadline;     // End of the budget of the current run
+    };
+
+    /**
+     * @brief When a world gives back the memory it doesn't use anymore, see ECS::setCompactPolicy()
+     */
+    struct CompactPolicy {
+        float utilization = 0.25f;          // Storage is shrunk once less than this fraction of it is in use
+        uint32_t interval = 0;              // Update() calls between two steps of the incremental compaction, 0 = compact() only
+        std::size_t step_entities = 65536;  // Free IDs an incremental step drops at most, 0 = no limit
     };
 }
 
@@ -0,0 +1,97 @@
+/*
+ *  Memory
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef MEMORY_HPP_
+    #define MEMORY_HPP_
+
+#include <cstddef>
+#include <new>
+#include <memory_resource>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace ECS {
+
+    /**
+     * @brief Memory resource backed by huge pages, meant as the upstream of a world-level arena
+     *
+     * std::pmr::unsynchronized_pool_resource arena(&huge_pages);
+     * ecs.setMemoryResource(&arena);
+     *
+     * Blocks are rounded up to whole huge pages and mapped directly. Explicit huge pages
+     * (MAP_HUGETLB) are tried first, then transparent huge pages are requested on a regular mapping.
+     * Outside of Linux this falls back to the global allocator.
+     */
+    class HugePageResource : public std::pmr::memory_resource {
+        public:
+            // Assumed huge page size
+            static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+        private:
+            static std::size_t roundUp(std::size_t bytes) {
+                if (bytes == 0)
+                    bytes = 1;
+                return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            }
+
+            void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+#if defined(__linux__)
+                if (alignment <= HUGE_PAGE_SIZE) {
+                    std::size_t size = roundUp(bytes);
+                    void *block = MAP_FAILED;
+
+    #ifdef MAP_HUGETLB
+                    block = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    #endif
+                    if (block == MAP_FAILED) {
+                        block = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                        if (block == MAP_FAILED)
+                            throw std::bad_alloc();
+    #ifdef MADV_HUGEPAGE
+                        madvise(block, size, MADV_HUGEPAGE);
+    #endif
+                    }
+                    return block;
+                }
+#endif
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+
+            void do_deallocate(void *block, std::size_t bytes, std::size_t alignment) override {
+#if defined(__linux__)
+                if (alignment <= HUGE_PAGE_SIZE) {
+                    munmap(block, roundUp(bytes));
+                    return;
+                }
+#endif
+                ::operator delete(block, std::align_val_t(alignment));
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+                return this == &other;
+            }
+    };
+}
+
+#endif /* !MEMORY_HPP_ */
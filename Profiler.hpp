@@ -0,0 +1,284 @@
+/*
+ *  Profiler
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef PROFILER_HPP_
+    #define PROFILER_HPP_
+
+#include "Includes.hpp"
+
+/*
+ * Everything below compiles out unless BLOB_ECS_PROFILING is defined before including the library
+ */
+#ifdef BLOB_ECS_PROFILING
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <ostream>
+#include <iomanip>
+#include <string_view>
+#include <thread>
+#include <functional>
+
+    #define BLOB_ECS_COUNT(counter, amount) ::ECS::ProfileCounters::add(::ECS::ProfileCounter::counter, amount)
+    #define BLOB_ECS_PROFILE_SCOPE(counter) ::ECS::ProfileScope blob_ecs_profile_scope_(::ECS::ProfileCounter::counter)
+
+    #ifndef BLOB_ECS_PROFILER_WINDOW
+        #define BLOB_ECS_PROFILER_WINDOW 256
+    #endif
+
+namespace ECS {
+
+    // Runs of a system the rolling statistics are computed over
+    constexpr std::size_t PROFILER_WINDOW = BLOB_ECS_PROFILER_WINDOW;
+
+    enum class ProfileCounter {
+        ENTITY_CREATES,
+        ENTITY_DELETES,
+        ENTITY_DELETE_NS,           // Time spent removing the components of deleted entities
+        POOL_REALLOCATIONS,         // Dense storage growths
+        SPARSE_PAGE_ALLOCATIONS,    // Sparse array pages allocated
+        SPARSE_TABLE_GROWTHS,       // Sparse array page tables grown
+        CACHE_REBUILDS,             // Full rebuilds of the sorted entity caches, see ComponentPool::getActiveEntities()
+        CACHE_REBUILD_NS,
+        COUNT
+    };
+
+    /**
+     * @brief Process-wide event counters, shared by every world
+     */
+    class ProfileCounters {
+        public:
+            static void add(ProfileCounter counter, uint64_t amount) {
+                s_values[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+            }
+
+            static uint64_t get(ProfileCounter counter) {
+                return s_values[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+            }
+
+            static void reset() {
+                for (auto &it : s_values)
+                    it.store(0, std::memory_order_relaxed);
+            }
+
+        private:
+            inline static std::atomic<uint64_t> s_values[static_cast<std::size_t>(ProfileCounter::COUNT)] = {};
+    };
+
+    /**
+     * @brief Adds the time spent in a scope to a counter
+     */
+    class ProfileScope {
+        public:
+            explicit ProfileScope(ProfileCounter counter)
+            : m_counter(counter), m_begin(std::chrono::steady_clock::now())
+            {}
+
+            ~ProfileScope() {
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_begin);
+
+                ProfileCounters::add(m_counter, static_cast<uint64_t>(elapsed.count()));
+            }
+
+            ProfileScope(const ProfileScope &) = delete;
+            ProfileScope &operator=(const ProfileScope &) = delete;
+
+        private:
+            ProfileCounter m_counter;
+            std::chrono::steady_clock::time_point m_begin;
+    };
+
+    /**
+     * @brief Statistics of the last PROFILER_WINDOW runs of a system
+     */
+    struct SystemTimings {
+        uint64_t calls = 0;                 // Runs since the profiler was reset, not only the window
+        std::chrono::nanoseconds last{0};
+        std::chrono::nanoseconds min{0};
+        std::chrono::nanoseconds avg{0};
+        std::chrono::nanoseconds p99{0};
+    };
+
+    /**
+     * @brief Times the systems of a world, see ECS::profiler()
+     *
+     * A system only records into its own slot, systems running in parallel never share state here.
+     */
+    class SystemProfiler {
+        public:
+            /**
+             * @brief Records a run of a system, called by ECS::Update()
+             *
+             * @param sys The system's ID
+             * @param begin When the run started
+             * @param end When the run ended
+             */
+            void record(SystemID sys, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+                Slot &slot = m_slots[sys];
+                std::chrono::nanoseconds duration = end - begin;
+
+                slot.samples[slot.calls % PROFILER_WINDOW] = duration;
+                slot.calls++;
+                if (m_tracing)
+                    slot.events.push_back(TraceEvent{begin, duration, std::hash<std::thread::id>{}(std::this_thread::get_id())});
+            }
+
+            /**
+             * @brief Makes room for the systems of a world, ECS::addSystem() calls it
+             *
+             * @param sys The system's ID
+             * @param name The name shown in traces
+             */
+            void declare(SystemID sys, std::string name) {
+                if (sys >= m_slots.size())
+                    m_slots.resize(sys + 1);
+                m_slots[sys].name = std::move(name);
+            }
+
+            /**
+             * @brief Computes the rolling statistics of a system
+             *
+             * @param sys The system's ID
+             * @return SystemTimings The statistics, zeroed if the system never ran
+             */
+            SystemTimings timings(SystemID sys) const {
+                SystemTimings result;
+
+                if (sys >= m_slots.size() || m_slots[sys].calls == 0)
+                    return result;
+
+                const Slot &slot = m_slots[sys];
+                std::size_t count = std::min<std::size_t>(slot.calls, PROFILER_WINDOW);
+                std::vector<std::chrono::nanoseconds> samples(slot.samples.begin(), slot.samples.begin() + count);
+                std::chrono::nanoseconds sum{0};
+
+                for (auto it : samples)
+                    sum += it;
+                result.calls = slot.calls;
+                result.last = slot.samples[(slot.calls - 1) % PROFILER_WINDOW];
+                result.avg = sum / static_cast<int64_t>(count);
+                result.min = *std::min_element(samples.begin(), samples.end());
+
+                auto p99 = samples.begin() + static_cast<std::ptrdiff_t>((count - 1) * 99 / 100);
+                std::nth_element(samples.begin(), p99, samples.end());
+                result.p99 = *p99;
+                return result;
+            }
+
+            /**
+             * @brief Starts or stops keeping every run for writeChromeTrace(), this memory grows until reset()
+             */
+            void setTracing(bool enabled) {
+                m_tracing = enabled;
+            }
+
+            /**
+             * @brief Forgets every recorded run, the declared systems are kept
+             */
+            void reset() {
+                for (Slot &slot : m_slots) {
+                    slot.calls = 0;
+                    slot.events.clear();
+                }
+            }
+
+            /**
+             * @brief Writes the traced runs in the Chrome trace event format
+             *
+             * The file opens in chrome://tracing or Perfetto, and in Tracy through its import-chrome tool.
+             * Times are written in microseconds with nanosecond digits, the stream's formatting is restored after.
+             *
+             * @param out The stream to write to
+             */
+            void writeChromeTrace(std::ostream &out) const {
+                std::ios_base::fmtflags flags = out.flags();
+                std::streamsize precision = out.precision();
+                bool first = true;
+
+                out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+                for (const Slot &slot : m_slots) {
+                    for (const TraceEvent &event : slot.events) {
+                        auto ts = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(event.begin.time_since_epoch());
+                        auto dur = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(event.duration);
+
+                        out << (first ? "" : ",") << "{\"name\":";
+                        writeJsonString(out, slot.name);
+                        out << ",\"ph\":\"X\",\"pid\":0,\"tid\":"
+                            << (event.thread & 0xFFFFFFFF) << ",\"ts\":" << ts.count() << ",\"dur\":" << dur.count() << "}";
+                        first = false;
+                    }
+                }
+                out << "]}";
+                out.flags(flags);
+                out.precision(precision);
+            }
+
+        private:
+            /**
+             * @brief Writes a string as a quoted JSON string, type names may hold quotes or backslashes
+             */
+            static void writeJsonString(std::ostream &out, std::string_view text) {
+                static constexpr char hex[] = "0123456789abcdef";
+
+                out << '"';
+                for (char c : text) {
+                    if (c == '"' || c == '\\')
+                        out << '\\' << c;
+                    else if (static_cast<unsigned char>(c) < 0x20)
+                        out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                    else
+                        out << c;
+                }
+                out << '"';
+            }
+
+            struct TraceEvent {
+                std::chrono::steady_clock::time_point begin;
+                std::chrono::nanoseconds duration;
+                std::size_t thread;
+            };
+
+            struct Slot {
+                std::string name;
+                uint64_t calls = 0;
+                std::vector<std::chrono::nanoseconds> samples = std::vector<std::chrono::nanoseconds>(PROFILER_WINDOW);
+                std::vector<TraceEvent> events;
+            };
+
+            std::vector<Slot> m_slots;
+            bool m_tracing = false;
+    };
+}
+
+#else
+
+    #define BLOB_ECS_COUNT(counter, amount) ((void)0)
+    #define BLOB_ECS_PROFILE_SCOPE(counter) ((void)0)
+
+#endif /* !BLOB_ECS_PROFILING */
+
+#endif /* !PROFILER_HPP_ */
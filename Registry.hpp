@@ -23,24 +23,40 @@
 #include <atomic>
 #include <cstdint>
 #include <vector>
-#include <array>
+#include <memory>
+#include <limits>
+#include <memory_resource>
 
 #include "Component.hpp"
+#include "ComponentList.hpp"
+#include "Archetype.hpp"
 
 #ifndef REGISTRY_HPP_
     #define REGISTRY_HPP_
 
 namespace ECS {
 
+    /**
+     * @brief Owns the component pools of an ECS, only the registered pools take memory
+     *
+     * Each registered type gets a slot, its bit in the entities' signatures,
+     * so that deleting an entity only touches the pools it actually is in.
+     * With StorageMode::ARCHETYPE the components live in an ArchetypeStorage instead of pools,
+     * the component methods below dispatch to whichever backend is in use.
+     */
     class Registry {
         public:
-            Registry() {}
-            ~Registry() {
-                for (const auto &it : m_pool_list) {
-                    if (it != nullptr)
-                        delete it;
-                }
+            /**
+             * @brief Construct a new Registry object
+             * 
+             * @param mode OPTIONAL the storage backend of the components
+             */
+            Registry(StorageMode mode = StorageMode::SPARSE_SET)
+            {
+                if (mode == StorageMode::ARCHETYPE)
+                    m_archetypes = std::make_unique<ArchetypeStorage>(m_signatures);
             }
+            ~Registry() {}
 
             /**
              * @brief Checks if a component type exists in the registry.
@@ -52,7 +68,7 @@ namespace ECS {
              * @return true if the component type exists and has an associated pool, false otherwise.
              */
             bool componentExists(uint16_t type_id) {
-                return m_pool_list[type_id] != nullptr;
+                return type_id < m_slot_of.size() && m_slot_of[type_id] != NULL_SLOT;
             }
 
             /**
@@ -75,47 +91,396 @@ namespace ECS {
              * @brief Registers a new component type to the registry
              * 
              * @tparam T The type to register
+             * @param capacity_hint OPTIONAL amount of components the pool reserves room for, ignored with archetypes
              * @return true If the component has been registered successfully
              * @return false If the component was already registered
+             * @throw ERROR::TooManyComponents => if MAX_COMPONENTS types are already registered
              */
             template <ComponentType T>
-            bool registerComponent() {
+            bool registerComponent(std::size_t capacity_hint = 0) {
                 if (componentExists<T>())
                     return false;
+                if (m_pools.size() >= MAX_COMPONENTS)
+                    throw ERROR::TooManyComponents(typeid(T).name(), MAX_COMPONENTS);
 
                 uint16_t type_id = ComponentTypeId::get<T>();
-                m_pool_list[type_id] = static_cast<IComponentPool*>(new ComponentPool<T>());
+                uint16_t slot = static_cast<uint16_t>(m_pools.size());
+
+                if (type_id >= m_slot_of.size())
+                    m_slot_of.resize(type_id + 1, NULL_SLOT);
+                if (m_archetypes) {
+                    m_pools.push_back(nullptr);
+                    m_archetypes->registerColumn<T>(slot);
+                } else {
+                    m_pools.push_back(std::make_unique<ComponentPool<T>>(capacity_hint, m_resource));
+                    m_pools.back()->setSignatureSlot(&m_signatures, slot);
+                    m_pools.back()->setTickSource(&m_change_tick);
+                }
+                m_slot_of[type_id] = slot;
                 return true;
             }
 
+            /**
+             * @brief Registers the types of a component list in order, so that each type's slot is its index in the list
+             * 
+             * @tparam List The ComponentList
+             * @param capacity_hint OPTIONAL amount of components every pool reserves room for, ignored with archetypes
+             * @throw ERROR::ComponentListMismatch => if a type ends up in another slot, i.e. other types were registered first
+             * @throw ERROR::TooManyComponents => if MAX_COMPONENTS types are already registered
+             */
+            template <ComponentListType List>
+            void registerComponents(std::size_t capacity_hint = 0) {
+                List::forEach([this, capacity_hint]<typename T>() {
+                    registerComponent<T>(capacity_hint);
+
+                    std::size_t slot = m_slot_of[ComponentTypeId::get<T>()];
+
+                    if (slot != List::template slotOf<T>())
+                        throw ERROR::ComponentListMismatch(std::string(typeName<T>()), List::template slotOf<T>(), slot);
+                });
+            }
+
+            /**
+             * @brief Sets the memory resource of the component storage, pools and archetypes created afterwards allocate from it
+             * 
+             * The resource must outlive the registry
+             * 
+             * @param resource The resource, nullptr for the default one
+             */
+            void setMemoryResource(std::pmr::memory_resource *resource) {
+                m_resource = resource != nullptr ? resource : std::pmr::get_default_resource();
+                if (m_archetypes)
+                    m_archetypes->setMemoryResource(m_resource);
+            }
+
             /**
              * @brief Get the Pool object
              * 
              * @tparam T The component type the pool stores
              * @return ComponentPool<T>& 
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::NoComponentPool => if the registry uses archetype storage
              */
             template <ComponentType T>
             ComponentPool<T> &getPool() {
                 if (!componentExists<T>())
                     throw ERROR::UnregisteredComponent(typeid(T).name());
-                return *(static_cast<ComponentPool<T>*>(m_pool_list[ComponentTypeId::get<T>()]));
+                if (m_archetypes)
+                    throw ERROR::NoComponentPool(typeid(T).name());
+                return *(static_cast<ComponentPool<T>*>(m_pools[m_slot_of[ComponentTypeId::get<T>()]].get()));
+            }
+
+            /**
+             * @brief Get the Pool object of a type of a component list, see registerComponents()
+             * 
+             * The slot is a constant, so this is a plain index into the pools.
+             * The checks below are only compiled without NDEBUG.
+             * 
+             * @tparam T The component type the pool stores, part of List
+             * @tparam List The ComponentList registered with registerComponents()
+             * @return ComponentPool<T>& 
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::ComponentListMismatch => if the list wasn't registered with registerComponents()
+             * @throw ERROR::NoComponentPool => if the registry uses archetype storage
+             */
+            template <ComponentType T, ComponentListType List>
+            ComponentPool<T> &getPool() {
+                constexpr std::size_t slot = List::template slotOf<T>();
+
+#ifndef NDEBUG
+                if (slotOf<T>() != slot)
+                    throw ERROR::ComponentListMismatch(std::string(typeName<T>()), slot, slotOf<T>());
+                if (m_archetypes)
+                    throw ERROR::NoComponentPool(typeid(T).name());
+#endif
+                return *(static_cast<ComponentPool<T>*>(m_pools[slot].get()));
+            }
+
+            /**
+             * @brief Returns the slot of a registered component type, its bit in the signatures
+             * 
+             * @tparam T The component type
+             * @return std::size_t The slot
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             */
+            template <ComponentType T>
+            std::size_t slotOf() {
+                if (!componentExists<T>())
+                    throw ERROR::UnregisteredComponent(typeid(T).name());
+                return m_slot_of[ComponentTypeId::get<T>()];
+            }
+
+            /**
+             * @brief Returns the components an entity has
+             * 
+             * @param e Entity ID
+             * @return ComponentMask The entity's signature, bits are the slots of the types
+             */
+            ComponentMask signature(EntityID e) const {
+                return m_signatures.get(entityIndex(e));
             }
 
             /**
-             * @brief Disables an entity from being computed
+             * @brief Builds the signature made of the specified components
+             * 
+             * @tparam Components The component types
+             * @return ComponentMask The mask with the slot of every component set
+             * @throw ERROR::UnregisteredComponent => if a component isn't registered
+             */
+            template <ComponentType... Components>
+            ComponentMask maskOf() {
+                ComponentMask mask;
+
+                (mask.set(slotOf<Components>()), ...);
+                return mask;
+            }
+
+            /**
+             * @brief Stores the signatures in an entity table, see SignatureTable::bind()
+             * 
+             * @param entities The table, indexed by entity index
+             */
+            void bindEntities(std::vector<Entity> *entities) {
+                m_signatures.bind(entities);
+            }
+
+            /**
+             * @brief Get the entity table holding the signatures
+             */
+            std::span<const Entity> entities() const {
+                return m_signatures.entities();
+            }
+
+            /**
+             * @brief Disables an entity from being computed, only the pools the entity is in are touched
              * 
              * @param e Entity ID
              */
             void disableEntity(EntityID e) {
-                for (const auto &it : m_pool_list) {
-                    if (it != nullptr)
-                        it->disableEntity(e);
+                if (m_archetypes) {
+                    m_archetypes->removeEntity(e);
+                    return;
+                }
+                m_signatures.get(entityIndex(e)).forEach([this, e](std::size_t slot) {
+                    m_pools[slot]->disableEntity(e);
+                });
+            }
+
+            /**
+             * @brief Brings the entity cache of every pool up to date, see ComponentPool::syncCache()
+             */
+            void syncCaches() {
+                for (const auto &it : m_pools) {
+                    if (it)
+                        it->syncCache();
+                }
+            }
+
+            /**
+             * @brief Writes every pool, in slot order, see ComponentPool::saveSnapshot()
+             * 
+             * @throw ERROR::SnapshotError => with StorageMode::ARCHETYPE, or if a component isn't trivially copyable
+             */
+            void saveSnapshot(SnapshotWriter &out) const {
+                if (m_archetypes)
+                    throw ERROR::SnapshotError("archetype storage can't be saved");
+                out.value<uint32_t>(static_cast<uint32_t>(m_pools.size()));
+                for (const auto &it : m_pools)
+                    it->saveSnapshot(out);
+            }
+
+            /**
+             * @brief Loads every pool written by saveSnapshot(), the components must have been registered in the same order
+             * 
+             * @throw ERROR::SnapshotError => if the registered components don't match the snapshot's
+             */
+            void loadSnapshot(SnapshotReader &in) {
+                if (m_archetypes)
+                    throw ERROR::SnapshotError("archetype storage can't be loaded");
+                if (in.value<uint32_t>() != m_pools.size())
+                    throw ERROR::SnapshotError("the registered components don't match");
+                for (const auto &it : m_pools)
+                    it->loadSnapshot(in);
+                // Each pool checked its own slot, the signatures must not hold others
+                for (const Entity &slot : m_signatures.entities()) {
+                    slot.components.forEach([this](std::size_t bit) {
+                        if (bit >= m_pools.size())
+                            throw ERROR::SnapshotError("entity signature of an unregistered component");
+                    });
                 }
             }
 
+            /**
+             * @brief Writes the changes of every pool after a tick, see ComponentPool::writeDelta()
+             * 
+             * @throw ERROR::SnapshotError => with StorageMode::ARCHETYPE, which doesn't track changes
+             */
+            void writeDelta(SnapshotWriter &out, uint32_t since) {
+                if (m_archetypes)
+                    throw ERROR::SnapshotError("archetype storage doesn't track changes");
+                out.value<uint32_t>(static_cast<uint32_t>(m_pools.size()));
+                for (const auto &it : m_pools)
+                    it->writeDelta(out, since);
+            }
+
+            /**
+             * @brief Applies the changes written by writeDelta(), pool by pool
+             * 
+             * @throw ERROR::SnapshotError => if the registered components don't match the delta's
+             */
+            void applyDelta(SnapshotReader &in) {
+                if (m_archetypes)
+                    throw ERROR::SnapshotError("archetype storage doesn't track changes");
+                if (in.value<uint32_t>() != m_pools.size())
+                    throw ERROR::SnapshotError("the registered components don't match");
+                for (const auto &it : m_pools)
+                    it->applyDelta(in);
+            }
+
+            /**
+             * @brief Forgets the removals every reader has seen, see ComponentPool::removedSince()
+             * 
+             * @param tick The oldest tick a reader may still ask for
+             */
+            void trimRemoved(uint32_t tick) {
+                for (const auto &it : m_pools) {
+                    if (it)
+                        it->trimRemoved(tick);
+                }
+            }
+
+            /**
+             * @brief Returns the amount of registered component types, slots are numbered from 0
+             */
+            std::size_t slotCount() const {
+                return m_pools.size();
+            }
+
+            /**
+             * @brief Releases the storage a slot's pool doesn't use, see ComponentPool::shrink()
+             * 
+             * @param slot The slot, nothing happens with archetypes, see shrinkArchetypes()
+             * @param utilization The fraction of the capacity under which the dense storage is shrunk
+             */
+            void shrinkPool(std::size_t slot, float utilization) {
+                if (slot < m_pools.size() && m_pools[slot])
+                    m_pools[slot]->shrink(utilization);
+            }
+
+            /**
+             * @brief Releases the chunks and the entity locations the archetypes don't use, see ArchetypeStorage::shrink()
+             * 
+             * @param extent The entity indices in use are lower than this
+             * @param utilization The fraction of the capacity under which the location table is shrunk
+             */
+            void shrinkArchetypes(std::size_t extent, float utilization) {
+                if (m_archetypes)
+                    m_archetypes->shrink(extent, utilization);
+            }
+
+            /**
+             * @brief Returns the tick the pools stamp additions, writes and removals with
+             * 
+             * @return uint32_t The current change tick
+             */
+            uint32_t changeTick() const {
+                return m_change_tick;
+            }
+
+            /**
+             * @brief Moves on to the next change tick, ECS::Update() calls it before each system runs
+             * 
+             * @return uint32_t The new change tick
+             */
+            uint32_t advanceChangeTick() {
+                return ++m_change_tick;
+            }
+
+            /**
+             * @brief Returns the archetype storage, nullptr if the registry uses sparse sets
+             */
+            ArchetypeStorage *archetypes() {
+                return m_archetypes.get();
+            }
+
+            /**
+             * @brief Adds the component to the specified entity, see ComponentPool::addComponent()
+             * 
+             * @tparam T The component type
+             * @param e The entity ID
+             * @return T& Reference to the newly created component
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::ComponentAlreadyAttached => if the entity already has the component
+             */
+            template <ComponentType T>
+            T &addComponent(EntityID e) {
+                if (m_archetypes)
+                    return m_archetypes->addComponent<T>(e, slotOf<T>());
+                return getPool<T>().addComponent(e);
+            }
+
+            /**
+             * @brief Adds a copy of a component to every specified entity, see ComponentPool::addComponentBulk()
+             * 
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             * @throw ERROR::ComponentAlreadyAttached => if an entity already has the component
+             */
+            template <ComponentType T, std::ranges::forward_range Range>
+            void addComponentBulk(const Range &entities, const T &prototype) {
+                if (m_archetypes)
+                    m_archetypes->addComponentBulk<T>(entities, prototype, slotOf<T>());
+                else
+                    getPool<T>().addComponentBulk(entities, prototype);
+            }
+
+            /**
+             * @brief Get the component attached to the specified entity, the entity must have it
+             * 
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             */
+            template <ComponentType T>
+            T &getComponent(EntityID e) {
+                if (m_archetypes)
+                    return m_archetypes->getComponent<T>(e, slotOf<T>());
+                return getPool<T>().getComponent(e);
+            }
+
+            /**
+             * @brief Removes the component attached to the specified entity, if any
+             * 
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             */
+            template <ComponentType T>
+            void removeComponent(EntityID e) {
+                if (m_archetypes)
+                    m_archetypes->removeComponent(e, slotOf<T>());
+                else
+                    getPool<T>().removeComponent(e);
+            }
+
+            /**
+             * @brief Applies a batch of additions and removals, see ComponentPool::applyCommands()
+             * 
+             * @throw ERROR::UnregisteredComponent => if the component isn't registered
+             */
+            template <ComponentType T>
+            void applyCommands(std::span<const ComponentCommand<T>> commands) {
+                if (m_archetypes)
+                    m_archetypes->applyCommands<T>(commands, slotOf<T>());
+                else
+                    getPool<T>().applyCommands(commands);
+            }
+
         protected:
         private:
-            IComponentPool *m_pool_list[UINT16_MAX]{nullptr};
+            static constexpr uint16_t NULL_SLOT = std::numeric_limits<uint16_t>::max();
+
+            std::vector<std::unique_ptr<IComponentPool>> m_pools;      // Registered pools, indexed by slot, nullptr with archetypes
+            std::vector<uint16_t> m_slot_of;                            // ComponentTypeId -> slot, grown on registration
+            SignatureTable m_signatures;
+            std::unique_ptr<ArchetypeStorage> m_archetypes;             // Set with StorageMode::ARCHETYPE
+            std::pmr::memory_resource *m_resource = std::pmr::get_default_resource();
+            uint32_t m_change_tick = 1;                                 // Stamped by the pools, 0 means "before any change"
     };
 }
 
@@ -0,0 +1,50 @@
+/*
+ *  Relationship
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef RELATIONSHIP_HPP_
+    #define RELATIONSHIP_HPP_
+
+#include <cstdint>
+
+#include "Includes.hpp"
+
+namespace ECS {
+
+    /**
+     * @brief The links of an entity within the hierarchy, see ECS::entitySetParent()
+     *
+     * The children of an entity form a doubly linked list, in the order they were attached,
+     * so that attaching and detaching never depend on the amount of siblings.
+     * The links are maintained by the ECS, don't add, remove or write this component directly.
+     * It's trivially copyable: the hierarchy is carried by snapshots and deltas like any other component.
+     */
+    struct Relationship {
+        EntityID parent = NULL_ENTITY;
+        EntityID first_child = NULL_ENTITY;
+        EntityID last_child = NULL_ENTITY;
+        EntityID prev_sibling = NULL_ENTITY;
+        EntityID next_sibling = NULL_ENTITY;
+        uint32_t children = 0;                          // Direct children only
+    };
+}
+
+#endif /* !RELATIONSHIP_HPP_ */
@@ -0,0 +1,375 @@
+/*
+ *  Simd
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef SIMD_HPP_
+    #define SIMD_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <span>
+#include <type_traits>
+#include <algorithm>
+
+#include "Includes.hpp"
+#include "Component.hpp"
+
+#if !defined(__GNUC__) && !defined(__clang__)
+    #error "Simd.hpp needs the GCC or Clang vector extensions"
+#endif
+
+// Vectors wider than the baseline ISA only cross function boundaries inside the dispatched paths
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace ECS {
+
+    /**
+     * @brief Instruction sets the batch kernels dispatch to, see simdLevel()
+     */
+    enum class SimdLevel {
+        SCALAR,     // 4 lanes, whatever the compiler makes of them
+        SSE,        // 4 lanes
+        AVX2,       // 8 lanes
+        AVX512,     // 16 lanes
+        NEON        // 4 lanes
+    };
+
+    /**
+     * @brief W floats processed as one value, GCC / Clang vector extensions lower it to the target's registers
+     */
+    template<std::size_t W>
+    struct SimdTypes {
+        // Attributes are dropped from dependent alias templates, member typedefs keep them
+        typedef float Float __attribute__((vector_size(W * sizeof(float))));
+        typedef int32_t Mask __attribute__((vector_size(W * sizeof(int32_t))));
+    };
+
+    template<std::size_t W>
+    using FloatBatch = typename SimdTypes<W>::Float;
+
+    /**
+     * @brief Lane-wise comparison results of FloatBatch<W>, -1 for true and 0 for false
+     */
+    template<std::size_t W>
+    using MaskBatch = typename SimdTypes<W>::Mask;
+
+    /**
+     * @brief Returns the amount of float lanes of an instruction set
+     */
+    constexpr std::size_t simdLanes(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::AVX512: return 16;
+            case SimdLevel::AVX2: return 8;
+            default: return 4;
+        }
+    }
+
+    /**
+     * @brief Detects the widest instruction set the CPU supports
+     */
+    inline SimdLevel detectSimdLevel() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.1"))
+            return SimdLevel::SSE;
+        return SimdLevel::SCALAR;
+#elif defined(__ARM_NEON)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    /**
+     * @brief Selects the path of the batch kernels, detected once per process
+     */
+    class SimdDispatch {
+        public:
+            /**
+             * @brief Returns the instruction set dispatchSimd() uses
+             */
+            static SimdLevel level() {
+                return current().load(std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Forces a narrower instruction set, e.g. to compare paths, wider than detectSimdLevel() is ignored
+             *
+             * @param level The instruction set
+             */
+            static void force(SimdLevel level) {
+                SimdLevel detected = detectSimdLevel();
+
+                if (level == SimdLevel::NEON ? detected != SimdLevel::NEON : (detected == SimdLevel::NEON || level > detected))
+                    level = detected;
+                current().store(level, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Calls fn(std::integral_constant<std::size_t, W>) compiled for the selected instruction set
+             *
+             * The trampolines are flattened, so that fn and the batch helpers it calls are compiled
+             * with the instruction set of the path they run on.
+             */
+            template<typename Func>
+            static void run(Func &&fn) {
+                switch (level()) {
+#if defined(__x86_64__) || defined(__i386__)
+                    case SimdLevel::AVX512: return runAvx512(fn);
+                    case SimdLevel::AVX2: return runAvx2(fn);
+                    case SimdLevel::SSE: return runSse(fn);
+#endif
+                    default: return runDefault(fn);
+                }
+            }
+
+        private:
+            static std::atomic<SimdLevel> &current() {
+                static std::atomic<SimdLevel> level = detectSimdLevel();
+                return level;
+            }
+
+#if defined(__x86_64__) || defined(__i386__)
+            template<typename Func>
+            [[gnu::target("avx512f,avx512dq,avx2,fma"), gnu::flatten]] static void runAvx512(Func &fn) {
+                fn(std::integral_constant<std::size_t, 16>{});
+            }
+
+            template<typename Func>
+            [[gnu::target("avx2,fma"), gnu::flatten]] static void runAvx2(Func &fn) {
+                fn(std::integral_constant<std::size_t, 8>{});
+            }
+
+            template<typename Func>
+            [[gnu::target("sse4.1"), gnu::flatten]] static void runSse(Func &fn) {
+                fn(std::integral_constant<std::size_t, 4>{});
+            }
+#endif
+
+            template<typename Func>
+            [[gnu::flatten]] static void runDefault(Func &fn) {
+                fn(std::integral_constant<std::size_t, 4>{});
+            }
+    };
+
+    /**
+     * @brief Returns the instruction set the batch kernels run with
+     */
+    inline SimdLevel simdLevel() {
+        return SimdDispatch::level();
+    }
+
+    /**
+     * @brief Runs a kernel written once for any width on the widest path of the CPU
+     *
+     * ECS::dispatchSimd([&](auto width) {
+     *     constexpr std::size_t W = decltype(width)::value;
+     *     ECS::forEachBatch<W>(count, [&](std::size_t i, std::size_t n) { ... });
+     * });
+     *
+     * @tparam Func The kernel type
+     * @param fn The kernel, called once with the lane count as a std::integral_constant
+     */
+    template<typename Func>
+    void dispatchSimd(Func &&fn) {
+        SimdDispatch::run(fn);
+    }
+
+    /**
+     * @brief Loads n <= W floats, the lanes past n are zeroed
+     */
+    template<std::size_t W>
+    inline FloatBatch<W> loadBatch(const float *data, std::size_t n = W) {
+        FloatBatch<W> result = {};
+
+        std::memcpy(&result, data, (n < W ? n : W) * sizeof(float));
+        return result;
+    }
+
+    /**
+     * @brief Stores the first n <= W lanes, the memory past them is left untouched
+     */
+    template<std::size_t W>
+    inline void storeBatch(float *data, const FloatBatch<W> &value, std::size_t n = W) {
+        std::memcpy(data, &value, (n < W ? n : W) * sizeof(float));
+    }
+
+    /**
+     * @brief Loads n <= W lanes from interleaved records, lane l reading data[l * stride]
+     */
+    template<std::size_t W>
+    inline FloatBatch<W> loadStrided(const float *data, std::size_t stride, std::size_t n = W) {
+        FloatBatch<W> result = {};
+
+        for (std::size_t l = 0; l < W; l++)
+            result[l] = l < n ? data[l * stride] : 0.0f;
+        return result;
+    }
+
+    /**
+     * @brief Cuts [0, count) in batches of W elements and calls fn(first, lanes) for each,
+     * lanes is W except for the masked tail
+     */
+    template<std::size_t W, typename Func>
+    inline void forEachBatch(std::size_t count, Func &&fn) {
+        std::size_t i = 0;
+
+        for (; i + W <= count; i += W)
+            fn(i, W);
+        if (i != count)
+            fn(i, count - i);
+    }
+
+    /**
+     * @brief Views the components of a split storage pool as one flat column of floats
+     *
+     * T must only hold floats, e.g. struct Position { float x, y, z; }; the column then reads x0 y0 z0 x1 y1 z1...
+     *
+     * @tparam T The component type
+     * @param components The components, see ComponentPool::components()
+     * @return std::span<float> The floats
+     */
+    template<typename T>
+    std::span<float> floatColumn(std::span<T> components) {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(float) == 0 && alignof(T) == alignof(float),
+            "floatColumn() requires a component made of floats only");
+        return {reinterpret_cast<float *>(components.data()), components.size() * (sizeof(T) / sizeof(float))};
+    }
+
+    /**
+     * @brief values[i] += rates[i] * dt over two flat columns, e.g. positions and velocities of the same layout
+     *
+     * @param values The integrated column
+     * @param rates The derivatives, only the first values.size() are read
+     * @param dt The time step
+     */
+    inline void integrateBatch(std::span<float> values, std::span<const float> rates, float dt) {
+        std::size_t count = std::min(values.size(), rates.size());
+
+        dispatchSimd([&](auto width) {
+            constexpr std::size_t W = decltype(width)::value;
+
+            forEachBatch<W>(count, [&](std::size_t i, std::size_t n) {
+                FloatBatch<W> v = loadBatch<W>(values.data() + i, n);
+
+                v += loadBatch<W>(rates.data() + i, n) * dt;
+                storeBatch<W>(values.data() + i, v, n);
+            });
+        });
+    }
+
+    /**
+     * @brief Tests boxes against a view box, boxes are interleaved as min x, min y, min z, max x, max y, max z
+     *
+     * @param boxes The boxes, 6 floats each
+     * @param view_min The view box's lower corner
+     * @param view_max The view box's upper corner
+     * @param visible Receives 1 for each box overlapping the view box and 0 for the others, boxes.size() / 6 entries
+     * @return std::size_t The amount of visible boxes
+     */
+    inline std::size_t cullAabbBatch(std::span<const float> boxes, std::array<float, 3> view_min, std::array<float, 3> view_max, std::span<uint8_t> visible) {
+        std::size_t count = std::min(boxes.size() / 6, visible.size());
+        std::size_t total = 0;
+
+        dispatchSimd([&](auto width) {
+            constexpr std::size_t W = decltype(width)::value;
+
+            forEachBatch<W>(count, [&](std::size_t i, std::size_t n) {
+                const float *box = boxes.data() + i * 6;
+                MaskBatch<W> in = ~MaskBatch<W>{};
+
+                // Gathers each field of W boxes into one register, then compares them all at once
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    in &= loadStrided<W>(box + axis, 6, n) <= view_max[axis];
+                    in &= loadStrided<W>(box + 3 + axis, 6, n) >= view_min[axis];
+                }
+                for (std::size_t l = 0; l < n; l++) {
+                    visible[i + l] = static_cast<uint8_t>(in[l] & 1);
+                    total += in[l] & 1;
+                }
+            });
+        });
+        return total;
+    }
+
+    /**
+     * @brief Integrates a pool with another one of the same layout, e.g. positions with velocities
+     *
+     * Runs of cells whose entities are in the same order in both pools go through the batch path,
+     * ecs.alignPools<Rate, T>() beforehand turns them into a single run. Components without
+     * a rate are left alone. Both types need ComponentTraits<T>::split_storage and must only hold floats.
+     * The writes aren't tracked.
+     *
+     * @param values The integrated pool
+     * @param rates The derivatives' pool
+     * @param dt The time step
+     * @return std::size_t The amount of runs, aligned pools holding the same entities make a single one
+     */
+    template<ComponentType T, ComponentType Rate>
+    std::size_t integratePools(ComponentPool<T> &values, ComponentPool<Rate> &rates, float dt) {
+        static_assert(sizeof(T) == sizeof(Rate), "integratePools() requires components of the same layout");
+        constexpr std::size_t lanes = sizeof(T) / sizeof(float);
+        std::span<float> value_column = floatColumn(values.components());
+        std::span<float> rate_column = floatColumn(rates.components());
+        std::span<const EntityID> entities = values.entities();
+        std::size_t runs = 0;
+
+        dispatchSimd([&](auto width) {
+            constexpr std::size_t W = decltype(width)::value;
+
+            for (std::size_t i = 0; i < entities.size();) {
+                if (!rates.hasComponent(entities[i])) {
+                    i++;
+                    continue;
+                }
+
+                std::size_t first = rates.denseIndexOf(entities[i]);
+                std::size_t length = 1;
+
+                while (i + length < entities.size() && first + length < rates.size()
+                    && rates.entityAt(first + length) == entities[i + length])
+                    length++;
+
+                float *value = value_column.data() + i * lanes;
+                const float *rate = rate_column.data() + first * lanes;
+
+                forEachBatch<W>(length * lanes, [&](std::size_t k, std::size_t n) {
+                    storeBatch<W>(value + k, loadBatch<W>(value + k, n) + loadBatch<W>(rate + k, n) * dt, n);
+                });
+                i += length;
+                runs++;
+            }
+        });
+        return runs;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+#endif /* !SIMD_HPP_ */
@@ -0,0 +1,346 @@
+/*
+ *  Snapshot
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef SNAPSHOT_HPP_
+    #define SNAPSHOT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <ostream>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "Errors.hpp"
+
+namespace ECS {
+
+    // Identifies snapshot files, "BECS"
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x53434542;
+    // Bumped whenever the layout of a snapshot changes
+    constexpr uint32_t SNAPSHOT_VERSION = 4;
+    // Identifies deltas, "BECD"
+    constexpr uint32_t DELTA_MAGIC = 0x44434542;
+
+    /**
+     * @brief FNV-1a hash of a type name, identifies pools in deltas with 4 bytes instead of the whole name
+     */
+    constexpr uint32_t nameHash(std::string_view name) {
+        uint32_t hash = 2166136261u;
+
+        for (char c : name)
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        return hash;
+    }
+
+    /**
+     * @brief Writes the raw blocks of a snapshot to a stream or appends them to a buffer, see ECS::saveSnapshot()
+     *
+     * Values are written in the host's byte order, snapshots are meant to be loaded on the same platform
+     */
+    class SnapshotWriter {
+        public:
+            explicit SnapshotWriter(std::ostream &out)
+            : m_stream(&out)
+            {}
+
+            explicit SnapshotWriter(std::vector<std::byte> &out)
+            : m_buffer(&out)
+            {}
+
+            void write(const void *data, std::size_t bytes) {
+                if (m_stream != nullptr) {
+                    m_stream->write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+                } else {
+                    const std::byte *begin = static_cast<const std::byte *>(data);
+
+                    m_buffer->insert(m_buffer->end(), begin, begin + bytes);
+                }
+            }
+
+            template<typename T>
+            void value(const T &value) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                write(&value, sizeof(T));
+            }
+
+            /**
+             * @brief Writes a block of trivially copyable values, preceded by its length
+             */
+            template<typename T>
+            void block(std::span<const T> values) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                value<uint64_t>(values.size());
+                write(values.data(), values.size_bytes());
+            }
+
+            void string(std::string_view text) {
+                value<uint32_t>(static_cast<uint32_t>(text.size()));
+                write(text.data(), text.size());
+            }
+
+        private:
+            std::ostream *m_stream = nullptr;
+            std::vector<std::byte> *m_buffer = nullptr;
+    };
+
+    /**
+     * @brief Reads a snapshot from memory, every read is bounds checked
+     */
+    class SnapshotReader {
+        public:
+            explicit SnapshotReader(std::span<const std::byte> data)
+            : m_data(data)
+            {}
+
+            /**
+             * @brief Returns the next bytes of the snapshot and moves past them
+             *
+             * @throw ERROR::SnapshotError => if the snapshot is shorter
+             */
+            const std::byte *take(std::size_t bytes) {
+                if (bytes > m_data.size() - m_offset)
+                    throw ERROR::SnapshotError("truncated data");
+
+                const std::byte *data = m_data.data() + m_offset;
+
+                m_offset += bytes;
+                return data;
+            }
+
+            template<typename T>
+            T value() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T result;
+
+                std::memcpy(&result, take(sizeof(T)), sizeof(T));
+                return result;
+            }
+
+            /**
+             * @brief Reads the length of a block written by SnapshotWriter::block()
+             */
+            template<typename T>
+            std::size_t blockSize() {
+                return blockSize(sizeof(T));
+            }
+
+            /**
+             * @brief Reads the length of a block of elements of a given size
+             */
+            std::size_t blockSize(std::size_t element_size) {
+                uint64_t count = value<uint64_t>();
+
+                if (count > (m_data.size() - m_offset) / element_size)
+                    throw ERROR::SnapshotError("truncated data");
+                return static_cast<std::size_t>(count);
+            }
+
+            /**
+             * @brief Copies a block of count values, see blockSize()
+             */
+            template<typename T>
+            void copy(T *out, std::size_t count) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                if (count != 0)
+                    std::memcpy(static_cast<void *>(out), take(count * sizeof(T)), count * sizeof(T));
+            }
+
+            std::string_view string() {
+                uint32_t size = value<uint32_t>();
+
+                return std::string_view(reinterpret_cast<const char *>(take(size)), size);
+            }
+
+        private:
+            std::span<const std::byte> m_data;
+            std::size_t m_offset = 0;
+    };
+
+    /**
+     * @brief Keeps the last deltas of a world, their buffers are reused so that steady state streaming doesn't allocate
+     *
+     * ecs.writeDelta(ring.push(ecs.changeTick()), id);
+     *
+     * Pushing into a full ring overwrites the oldest delta. The kept deltas can be streamed
+     * to clients, or replayed in order for rollback.
+     */
+    class DeltaRing {
+        public:
+            /**
+             * @brief Construct a new DeltaRing object
+             *
+             * @param slots The amount of deltas kept, at least 1
+             */
+            explicit DeltaRing(std::size_t slots)
+            : m_slots(std::max<std::size_t>(slots, 1))
+            {}
+
+            /**
+             * @brief Takes the next slot, overwriting the oldest delta once the ring is full
+             *
+             * @param tick The tick the delta is taken at, see ECS::changeTick()
+             * @return std::vector<std::byte>& The slot's buffer, emptied but keeping its capacity
+             */
+            std::vector<std::byte> &push(uint32_t tick) {
+                Slot &slot = m_slots[(m_first + m_count) % m_slots.size()];
+
+                if (m_count == m_slots.size())
+                    m_first = (m_first + 1) % m_slots.size();
+                else
+                    m_count++;
+                slot.tick = tick;
+                slot.bytes.clear();
+                return slot.bytes;
+            }
+
+            /**
+             * @brief Get a kept delta, 0 being the oldest
+             */
+            std::span<const std::byte> at(std::size_t i) const {
+                return m_slots[(m_first + i) % m_slots.size()].bytes;
+            }
+
+            /**
+             * @brief Get the tick of a kept delta, 0 being the oldest
+             */
+            uint32_t tickAt(std::size_t i) const {
+                return m_slots[(m_first + i) % m_slots.size()].tick;
+            }
+
+            /**
+             * @brief Finds the delta taken at a tick
+             *
+             * @return std::span<const std::byte> The delta, empty if it isn't kept anymore
+             */
+            std::span<const std::byte> find(uint32_t tick) const {
+                for (std::size_t i = 0; i < m_count; i++) {
+                    if (tickAt(i) == tick)
+                        return at(i);
+                }
+                return {};
+            }
+
+            std::size_t size() const { return m_count; }
+            std::size_t capacity() const { return m_slots.size(); }
+
+            void clear() {
+                m_first = 0;
+                m_count = 0;
+            }
+
+        private:
+            struct Slot {
+                uint32_t tick = 0;
+                std::vector<std::byte> bytes;
+            };
+
+            std::vector<Slot> m_slots;
+            std::size_t m_first = 0;
+            std::size_t m_count = 0;
+    };
+
+    /**
+     * @brief Read-only view of a whole file, mapped in memory where possible
+     *
+     * Outside of Linux the file is read into a buffer instead.
+     */
+    class MappedFile {
+        public:
+            /**
+             * @brief Maps a file
+             *
+             * @param path The file's path
+             * @throw ERROR::SnapshotError => if the file can't be opened
+             */
+            explicit MappedFile(const std::string &path) {
+#if defined(__linux__)
+                int fd = open(path.c_str(), O_RDONLY);
+                struct stat info;
+
+                if (fd < 0)
+                    throw ERROR::SnapshotError("cannot open " + path);
+                if (fstat(fd, &info) != 0) {
+                    close(fd);
+                    throw ERROR::SnapshotError("cannot read " + path);
+                }
+                m_size = static_cast<std::size_t>(info.st_size);
+                if (m_size != 0) {
+                    m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+                    if (m_mapping == MAP_FAILED) {
+                        close(fd);
+                        throw ERROR::SnapshotError("cannot map " + path);
+                    }
+                }
+                close(fd);
+#else
+                std::ifstream in(path, std::ios::binary);
+
+                if (!in)
+                    throw ERROR::SnapshotError("cannot open " + path);
+                m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                m_size = m_buffer.size();
+#endif
+            }
+
+            ~MappedFile() {
+#if defined(__linux__)
+                if (m_mapping != nullptr)
+                    munmap(m_mapping, m_size);
+#endif
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            std::span<const std::byte> bytes() const {
+#if defined(__linux__)
+                return {static_cast<const std::byte *>(m_mapping), m_size};
+#else
+                return {reinterpret_cast<const std::byte *>(m_buffer.data()), m_size};
+#endif
+            }
+
+        private:
+            std::size_t m_size = 0;
+#if defined(__linux__)
+            void *m_mapping = nullptr;
+#else
+            std::vector<char> m_buffer;
+#endif
+    };
+}
+
+#endif /* !SNAPSHOT_HPP_ */
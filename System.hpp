@@ -23,10 +23,59 @@
 #ifndef SYSTEM_HPP_
     #define SYSTEM_HPP_
 
-#include "ECS.hpp"
+#include <vector>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "Includes.hpp"
+#include "Component.hpp"
 
 namespace ECS {
 
+    /**
+     * @brief Lists the component types a system reads, declare it as a member of the system:
+     * using reads = ECS::Reads<Position, Velocity>;
+     * 
+     * @tparam Components The component types
+     */
+    template<ComponentType... Components>
+    struct Reads {
+        static std::vector<uint16_t> ids() { return {ComponentTypeId::get<Components>()...}; }
+    };
+
+    /**
+     * @brief Lists the component types a system writes, declare it as a member of the system:
+     * using writes = ECS::Writes<Position>;
+     * 
+     * Systems declaring neither reads nor writes are considered to access everything
+     * and never run alongside other systems.
+     * 
+     * @tparam Components The component types
+     */
+    template<ComponentType... Components>
+    struct Writes {
+        static std::vector<uint16_t> ids() { return {ComponentTypeId::get<Components>()...}; }
+    };
+
+    /**
+     * @brief Builds the access sets of a system class from its reads/writes declarations
+     * 
+     * @tparam T The system class
+     * @param data The system's data to fill
+     */
+    template<typename T>
+    void declareSystemAccess(SystemData &data) {
+        constexpr bool has_reads = requires { typename T::reads; };
+        constexpr bool has_writes = requires { typename T::writes; };
+
+        data.exclusive = !has_reads && !has_writes;
+        if constexpr (has_reads)
+            data.reads = T::reads::ids();
+        if constexpr (has_writes)
+            data.writes = T::writes::ids();
+    }
+
     /**
      * @brief System Interface, every system should inherit from this class
      */
@@ -38,5 +87,76 @@ namespace ECS {
         protected:
         private:
     };
+
+    // Concept for accepting the systems of a pipeline, deriving from ISystem is not required
+    template<typename T>
+    concept PipelineSystem = std::is_default_constructible_v<T> && requires(T &sys, ECS &ecs, SystemID id, uint32_t msecs) {
+        sys.Update(ecs, id, msecs);
+    };
+
+    /**
+     * @brief Type-erased pipeline, ECS::Update() makes one indirect call per pipeline instead of one per system
+     */
+    class ISystemPipeline {
+        public:
+            virtual ~ISystemPipeline() = default;
+
+            /**
+             * @brief Runs every due system of the pipeline, in order
+             * 
+             * @param first The ID of the first system of the pipeline
+             */
+            virtual void Update(ECS &, SystemID first, uint32_t msecs) = 0;
+
+            /**
+             * @brief Runs a single system of the pipeline, the scheduling (tickrate, change ticks) is up to the caller
+             * 
+             * @param first The ID of the first system of the pipeline
+             * @param index The position of the system within the pipeline
+             */
+            virtual void UpdateOne(ECS &, SystemID first, std::size_t index, uint32_t msecs) = 0;
+    };
+
+    /**
+     * @brief Systems known at compile time, stored by value next to each other and called directly
+     * 
+     * ecs.addPipeline<InputSystem, PhysicsSystem, RenderSystem>();
+     * 
+     * Their Update() is called through a qualified name, virtual or not it is a direct call the compiler can inline.
+     * 
+     * @tparam Systems The system classes, in execution order
+     */
+    template<PipelineSystem... Systems>
+    class SystemPipeline : public ISystemPipeline {
+        public:
+            void Update(ECS &ecs, SystemID first, uint32_t msecs) override;
+            void UpdateOne(ECS &ecs, SystemID first, std::size_t index, uint32_t msecs) override;
+
+            /**
+             * @brief Get the instance of a system of the pipeline
+             * 
+             * @tparam T The system class
+             * @return T& The instance
+             */
+            template<PipelineSystem T>
+            T &get() {
+                return std::get<T>(m_systems);
+            }
+
+        private:
+            std::tuple<Systems...> m_systems;
+
+            template<std::size_t I>
+            using SystemAt = std::tuple_element_t<I, std::tuple<Systems...>>;
+
+            template<std::size_t I>
+            void call(ECS &ecs, SystemID id, uint32_t msecs) {
+                std::get<I>(m_systems).SystemAt<I>::Update(ecs, id, msecs);
+            }
+    };
 }
+
+// Included last so that including System.hpp alone defines ISystem before the ECS class uses it
+#include "ECS.hpp"
+
 #endif /* !SYSTEM_HPP_ */
@@ -0,0 +1,321 @@
+/*
+ *  ThreadPool
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef THREADPOOL_HPP_
+    #define THREADPOOL_HPP_
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <algorithm>
+
+namespace ECS {
+
+    /**
+     * @brief A set of tasks that can be waited on as a whole, see ThreadPool::run() and ThreadPool::wait()
+     */
+    class TaskGroup {
+        public:
+            TaskGroup() = default;
+            TaskGroup(const TaskGroup &) = delete;
+            TaskGroup &operator=(const TaskGroup &) = delete;
+
+        private:
+            friend class ThreadPool;
+
+            std::atomic<std::size_t> m_pending = 0;
+            std::mutex m_error_mutex;
+            std::exception_ptr m_error;
+    };
+
+    /**
+     * @brief Fixed-size pool of work-stealing worker threads
+     *
+     * Each worker owns a task deque: tasks queued from a worker go to its own deque and are
+     * taken back LIFO, idle workers steal from the other end of their peers' deques. Tasks
+     * queued from other threads go to a shared injection deque.
+     * A thread waiting on a TaskGroup executes queued tasks while it waits,
+     * so tasks may themselves run and wait on other groups without deadlocking.
+     */
+    class ThreadPool {
+        public:
+            // Default amount of elements handed to a task by parallelFor()
+            static constexpr std::size_t DEFAULT_CHUNK_SIZE = 1024;
+
+            /**
+             * @brief Construct a new ThreadPool object
+             *
+             * @param workers OPTIONAL amount of worker threads, 0 = one less than the hardware concurrency
+             */
+            ThreadPool(std::size_t workers = 0)
+            {
+                if (workers == 0) {
+                    unsigned int hw = std::thread::hardware_concurrency();
+                    workers = hw > 1 ? hw - 1 : 1;
+                }
+                // One deque per worker, plus the injection deque
+                for (std::size_t i = 0; i <= workers; i++)
+                    m_queues.push_back(std::make_unique<TaskQueue>());
+                m_workers.reserve(workers);
+                for (std::size_t i = 0; i < workers; i++)
+                    m_workers.emplace_back([this, i]() { workerLoop(i); });
+            }
+
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                    m_stopping = true;
+                }
+                m_wakeup.notify_all();
+                for (auto &it : m_workers)
+                    it.join();
+            }
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            /**
+             * @brief Process-wide pool, created on first use
+             *
+             * @return ThreadPool& The shared pool
+             */
+            static ThreadPool &shared() {
+                static ThreadPool pool;
+                return pool;
+            }
+
+            /**
+             * @brief Returns the amount of worker threads, the calling thread of wait() excluded
+             *
+             * @return std::size_t Worker count
+             */
+            std::size_t workerCount() const {
+                return m_workers.size();
+            }
+
+            /**
+             * @brief Queues a task as part of a group
+             *
+             * @param group The group the task belongs to
+             * @param task The task, exceptions it throws are rethrown by wait()
+             */
+            void run(TaskGroup &group, std::function<void()> task) {
+                push(t_pool == this ? t_worker : m_workers.size(), group, std::move(task));
+            }
+
+            /**
+             * @brief Queues a task on a given worker's deque, the worker runs it unless an idle one steals it first
+             *
+             * @param worker The worker's index, wrapped around workerCount()
+             * @param group The group the task belongs to
+             * @param task The task, exceptions it throws are rethrown by wait()
+             */
+            void runOn(std::size_t worker, TaskGroup &group, std::function<void()> task) {
+                push(worker % m_workers.size(), group, std::move(task));
+            }
+
+            /**
+             * @brief Blocks until every task of the group is done, executing queued tasks meanwhile
+             *
+             * @param group The group to wait for
+             * @throw The first exception thrown by a task of the group
+             */
+            void wait(TaskGroup &group) {
+                std::size_t self = t_pool == this ? t_worker : m_workers.size();
+
+                while (group.m_pending.load(std::memory_order_acquire) != 0) {
+                    Task task;
+
+                    if (findTask(self, task)) {
+                        execute(task);
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                    m_wakeup.wait(lock, [&]() {
+                        return group.m_pending.load(std::memory_order_acquire) == 0
+                            || m_queued.load(std::memory_order_acquire) != 0;
+                    });
+                }
+                if (group.m_error) {
+                    std::exception_ptr error = group.m_error;
+
+                    group.m_error = nullptr;
+                    std::rethrow_exception(error);
+                }
+            }
+
+            /**
+             * @brief Splits [0, count) in chunks and calls fn(begin, end) for each of them on the pool,
+             * returns once every chunk is done
+             *
+             * @tparam Func The callable type
+             * @param count The amount of elements
+             * @param chunk_size The amount of elements per chunk, 0 = DEFAULT_CHUNK_SIZE
+             * @param fn The callable
+             */
+            template<typename Func>
+            void parallelFor(std::size_t count, std::size_t chunk_size, Func &&fn) {
+                if (chunk_size == 0)
+                    chunk_size = DEFAULT_CHUNK_SIZE;
+                if (count <= chunk_size) {
+                    if (count != 0)
+                        fn(std::size_t(0), count);
+                    return;
+                }
+
+                TaskGroup group;
+                for (std::size_t begin = 0; begin < count; begin += chunk_size) {
+                    std::size_t end = std::min(count, begin + chunk_size);
+
+                    run(group, [&fn, begin, end]() { fn(begin, end); });
+                }
+                wait(group);
+            }
+
+        private:
+            struct Task {
+                TaskGroup *group = nullptr;
+                std::function<void()> fn;
+            };
+
+            struct TaskQueue {
+                std::mutex mutex;
+                std::deque<Task> tasks;
+            };
+
+            inline static thread_local ThreadPool *t_pool = nullptr;        // Pool the calling thread works for
+            inline static thread_local std::size_t t_worker = 0;            // Its index within that pool
+
+            std::vector<std::thread> m_workers;
+            std::vector<std::unique_ptr<TaskQueue>> m_queues;               // Worker deques, then the injection deque
+            std::atomic<std::size_t> m_queued = 0;                          // Tasks sitting in any deque
+            std::mutex m_sleep_mutex;
+            std::condition_variable m_wakeup;                               // Idle workers and waiters sleep here
+            bool m_stopping = false;
+
+            void push(std::size_t queue, TaskGroup &group, std::function<void()> task) {
+                group.m_pending.fetch_add(1, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+                    m_queues[queue]->tasks.push_back(Task{&group, std::move(task)});
+                }
+                m_queued.fetch_add(1, std::memory_order_release);
+                {
+                    // Lock so the notification can't slip between a sleeper's check and its sleep
+                    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                }
+                m_wakeup.notify_one();
+            }
+
+            /**
+             * @brief Takes a task: newest of its own deque, then oldest of the injection deque, then steals
+             *
+             * @param self The queue index of the calling thread, the injection deque for non-workers
+             */
+            bool findTask(std::size_t self, Task &task) {
+                std::size_t count = m_queues.size();
+
+                if (m_queued.load(std::memory_order_acquire) == 0)
+                    return false;
+                if (self != count - 1 && popBack(*m_queues[self], task))
+                    return true;
+                for (std::size_t i = 0; i < count; i++) {
+                    std::size_t victim = (count - 1 + i) % count;
+
+                    if (victim != self || self == count - 1) {
+                        if (popFront(*m_queues[victim], task))
+                            return true;
+                    }
+                }
+                return false;
+            }
+
+            bool popBack(TaskQueue &queue, Task &task) {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+
+                if (queue.tasks.empty())
+                    return false;
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            bool popFront(TaskQueue &queue, Task &task) {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+
+                if (queue.tasks.empty())
+                    return false;
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            void execute(Task &task) {
+                TaskGroup *group = task.group;
+
+                try {
+                    task.fn();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(group->m_error_mutex);
+                    if (!group->m_error)
+                        group->m_error = std::current_exception();
+                }
+                task.fn = nullptr;
+                if (group->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    {
+                        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                    }
+                    m_wakeup.notify_all();
+                }
+            }
+
+            void workerLoop(std::size_t index) {
+                t_pool = this;
+                t_worker = index;
+                while (true) {
+                    Task task;
+
+                    if (findTask(index, task)) {
+                        execute(task);
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                    m_wakeup.wait(lock, [this]() {
+                        return m_stopping || m_queued.load(std::memory_order_acquire) != 0;
+                    });
+                    if (m_stopping && m_queued.load(std::memory_order_acquire) == 0)
+                        return;
+                }
+            }
+    };
+}
+
+#endif /* !THREADPOOL_HPP_ */
@@ -0,0 +1,527 @@
+/*
+ *  View
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef VIEW_HPP_
+    #define VIEW_HPP_
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <array>
+
+#include "Includes.hpp"
+#include "Component.hpp"
+#include "Archetype.hpp"
+#include "ThreadPool.hpp"
+
+namespace ECS {
+
+    /**
+     * @brief Exclusion filter of a query, see ECS::view(NoneOf<...>)
+     * 
+     * @tparam Components The component types the entities must not have
+     */
+    template<ComponentType... Components>
+    struct NoneOf {};
+
+    /**
+     * @brief Query term keeping only the entities whose T was written since the view's tick, see View::since()
+     *
+     * A write is an emplace, an assignment through a command buffer or ECS::entityMarkChanged()
+     *
+     * @tparam T The component type
+     */
+    template<ComponentType T>
+    struct Changed {};
+
+    /**
+     * @brief Query term keeping only the entities that received T since the view's tick, see View::since()
+     *
+     * @tparam T The component type
+     */
+    template<ComponentType T>
+    struct Added {};
+
+    enum class TermFilter {
+        NO_FILTER,
+        CHANGED,
+        ADDED
+    };
+
+    /**
+     * @brief Splits a query term into its component type and its filter
+     */
+    template<typename Term>
+    struct QueryTerm {
+        using component = Term;
+        static constexpr TermFilter filter = TermFilter::NO_FILTER;
+    };
+
+    template<typename T>
+    struct QueryTerm<Changed<T>> {
+        using component = T;
+        static constexpr TermFilter filter = TermFilter::CHANGED;
+    };
+
+    template<typename T>
+    struct QueryTerm<Added<T>> {
+        using component = T;
+        static constexpr TermFilter filter = TermFilter::ADDED;
+    };
+
+    template<typename Term>
+    using TermComponent = typename QueryTerm<Term>::component;
+
+    /**
+     * @brief Non-owning view over every entity that has ALL of the specified components
+     *
+     * The view walks the dense array of the smallest pool and checks the other pools
+     * through their sparse arrays, it never allocates.
+     * Over archetype storage, the view walks the chunks of every matching archetype linearly instead.
+     * Adding or removing components of the viewed types while iterating is undefined behaviour.
+     * Changed<T> and Added<T> terms also require T to have been written or added after the view's tick,
+     * they match every entity over archetype storage which does not track changes.
+     *
+     * @tparam Components The component types (or Changed<T> / Added<T> terms) the entities must have
+     */
+    template<ComponentType... Components>
+    class View {
+        static_assert(sizeof...(Components) > 0, "A view needs at least one component type");
+
+        public:
+            /**
+             * @brief Construct a new View object, a nullptr pool produces an empty view
+             *
+             * @param pools One pool per component type
+             */
+            View(ComponentPool<TermComponent<Components>> *...pools)
+            : m_pools(pools...), m_lead(0), m_lead_size(0)
+            {
+                selectLead();
+            }
+
+            /**
+             * @brief Construct a new View object that filters candidates with the entities' signatures
+             *
+             * Checking a candidate then takes a single mask compare instead of one sparse lookup per pool
+             *
+             * @param entities The entity table holding the signatures
+             * @param mask The signature bits of the viewed components
+             * @param pools One pool per component type
+             */
+            View(const std::vector<Entity> *entities, const ComponentMask &mask, ComponentPool<TermComponent<Components>> *...pools)
+            : m_pools(pools...), m_lead(0), m_lead_size(0), m_entities(entities), m_mask(mask)
+            {
+                selectLead();
+            }
+
+            /**
+             * @brief Construct a new View object over archetype storage
+             * 
+             * @param archetypes The storage
+             * @param entities The entity table holding the signatures
+             * @param mask The signature bits of the viewed components
+             * @param slots The slot of each component type
+             */
+            View(ArchetypeStorage *archetypes, const std::vector<Entity> *entities, const ComponentMask &mask, std::array<std::size_t, sizeof...(Components)> slots)
+            : m_pools(static_cast<ComponentPool<TermComponent<Components>> *>(nullptr)...), m_lead(0), m_lead_size(0),
+              m_entities(entities), m_mask(mask), m_archetypes(archetypes), m_slots(slots)
+            {
+                countArchetypes();
+            }
+
+            /**
+             * @brief Leaves out the entities that have any of the components of a mask
+             * 
+             * Only views built with the entities' signatures can exclude, i.e. the ones returned by ECS::view()
+             * 
+             * @param mask The signature bits of the excluded components
+             * @return View& This view
+             */
+            View &exclude(const ComponentMask &mask) {
+                m_exclude = mask;
+                if (m_archetypes != nullptr)
+                    countArchetypes();
+                return *this;
+            }
+
+            /**
+             * @brief Sets the tick the Changed<T> and Added<T> terms compare against, see Registry::changeTick()
+             *
+             * ECS::view(SystemID) sets it to the tick of the system's previous run
+             *
+             * @param tick Only the writes stamped after this tick pass the filters
+             * @return View& This view
+             */
+            View &since(uint32_t tick) {
+                m_since = tick;
+                return *this;
+            }
+
+            /**
+             * @brief Calls fn(EntityID, Components&...) for each entity of the view
+             *
+             * @tparam Func The callable type
+             * @param fn The callable
+             */
+            template<typename Func>
+            void each(Func &&fn) {
+                if (m_lead_size == 0)
+                    return;
+                if (m_archetypes != nullptr) {
+                    for (std::size_t i = 0; i < m_archetypes->archetypeCount(); i++) {
+                        Archetype &archetype = m_archetypes->archetypeAt(i);
+
+                        if (matches(archetype))
+                            eachChunks(fn, archetype, 0, archetype.chunkCount());
+                    }
+                    return;
+                }
+                dispatchLead([&]<std::size_t Lead>() { this->eachFrom<Lead>(fn, 0, m_lead_size); });
+            }
+
+            /**
+             * @brief Calls fn(EntityID, Components&...) for each entity of the view,
+             * chunks of the smallest pool's dense array run in parallel
+             *
+             * fn must be safe to call concurrently on different entities.
+             *
+             * @tparam Func The callable type
+             * @param fn The callable
+             * @param chunk_size OPTIONAL candidates per task, rounded up to whole cache lines
+             * (whole archetype chunks over archetype storage), 0 = ThreadPool::DEFAULT_CHUNK_SIZE
+             * @param pool OPTIONAL the pool to run the chunks on
+             */
+            template<typename Func>
+            void parallelForEach(Func &&fn, std::size_t chunk_size = 0, ThreadPool &pool = ThreadPool::shared()) {
+                if (m_lead_size == 0)
+                    return;
+                if (m_archetypes != nullptr) {
+                    TaskGroup group;
+
+                    if (chunk_size == 0)
+                        chunk_size = ThreadPool::DEFAULT_CHUNK_SIZE;
+                    for (std::size_t i = 0; i < m_archetypes->archetypeCount(); i++) {
+                        Archetype &archetype = m_archetypes->archetypeAt(i);
+                        std::size_t per_task = std::max<std::size_t>(chunk_size / archetype.chunkCapacity(), 1);
+
+                        if (!matches(archetype))
+                            continue;
+                        for (std::size_t begin = 0; begin < archetype.chunkCount(); begin += per_task) {
+                            std::size_t end = std::min(archetype.chunkCount(), begin + per_task);
+
+                            pool.run(group, [this, &fn, &archetype, begin, end]() { this->eachChunks(fn, archetype, begin, end); });
+                        }
+                    }
+                    pool.wait(group);
+                    return;
+                }
+                dispatchLead([&]<std::size_t Lead>() {
+                    pool.parallelFor(m_lead_size, PoolAt<Lead>::alignChunkSize(chunk_size), [this, &fn](std::size_t begin, std::size_t end) {
+                        this->eachFrom<Lead>(fn, begin, end);
+                    });
+                });
+            }
+
+            /**
+             * @brief Upper bound of the entity count, this is the size of the smallest pool
+             * (the exact count over archetype storage)
+             *
+             * @return std::size_t The amount of candidates the view walks through
+             */
+            std::size_t sizeHint() const {
+                return m_lead_size;
+            }
+
+            /**
+             * @brief Checks if a specific entity is part of the view
+             *
+             * @param e The entity ID
+             * @return true if the entity has every component of the view
+             * @return false otherwise
+             */
+            bool contains(EntityID e) {
+                if (m_lead_size == 0)
+                    return false;
+                if (m_archetypes != nullptr)
+                    return m_archetypes->hasEntity(e) && containsIndex(entityIndex(e));
+                if (m_entities != nullptr && !containsIndex(entityIndex(e)))
+                    return false;
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return (std::get<I>(m_pools)->hasComponent(e) && ...);
+                }(std::index_sequence_for<Components...>{});
+            }
+
+            /**
+             * @brief Checks if the entity occupying an index is part of the view, see ComponentPool::hasIndex()
+             *
+             * @param index The entity index
+             * @return true if the entity has every component of the view
+             * @return false otherwise
+             */
+            bool containsIndex(EntityIndex index) {
+                if (m_lead_size == 0)
+                    return false;
+                if (m_entities != nullptr) {
+                    if (index >= m_entities->size())
+                        return false;
+
+                    const ComponentMask &signature = (*m_entities)[index].components;
+
+                    return signature.containsAll(m_mask) && !signature.intersects(m_exclude);
+                }
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return (std::get<I>(m_pools)->hasIndex(index) && ...);
+                }(std::index_sequence_for<Components...>{});
+            }
+
+            class Iterator {
+                public:
+                    using value_type = std::tuple<EntityID, TermComponent<Components> &...>;
+
+                    // Over archetype storage, index is the archetype and row the row within it
+                    Iterator(View *view, std::size_t index)
+                    : m_view(view), m_index(index), m_row(0)
+                    {
+                        skipInvalid();
+                    }
+
+                    value_type operator*() const {
+                        if (m_view->m_archetypes != nullptr) {
+                            Archetype &archetype = m_view->m_archetypes->archetypeAt(m_index);
+
+                            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                                return value_type(archetype.entityAt(m_row),
+                                    archetype.componentAt<TermComponent<Components>>(archetype.columnOf(m_view->m_slots[I]), m_row)...);
+                            }(std::index_sequence_for<Components...>{});
+                        }
+
+                        EntityID e = m_view->leadEntity(m_index);
+                        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                            return value_type(e, std::get<I>(m_view->m_pools)->getComponent(e)...);
+                        }(std::index_sequence_for<Components...>{});
+                    }
+
+                    Iterator &operator++() {
+                        if (m_view->m_archetypes != nullptr)
+                            m_row++;
+                        else
+                            m_index++;
+                        skipInvalid();
+                        return *this;
+                    }
+
+                    bool operator==(const Iterator &other) const {
+                        return m_index == other.m_index && m_row == other.m_row;
+                    }
+
+                private:
+                    View *m_view;
+                    std::size_t m_index;
+                    std::size_t m_row;
+
+                    void skipInvalid() {
+                        if (m_view->m_archetypes != nullptr) {
+                            ArchetypeStorage &storage = *m_view->m_archetypes;
+
+                            while (m_index < storage.archetypeCount()
+                                && (m_row >= storage.archetypeAt(m_index).size() || !m_view->matches(storage.archetypeAt(m_index)))) {
+                                m_index++;
+                                m_row = 0;
+                            }
+                            return;
+                        }
+                        while (m_index < m_view->m_lead_size && !m_view->acceptsLead(m_index))
+                            m_index++;
+                    }
+            };
+
+            Iterator begin() { return Iterator(this, 0); }
+            Iterator end() { return Iterator(this, m_archetypes != nullptr ? m_archetypes->archetypeCount() : m_lead_size); }
+
+        private:
+            std::tuple<ComponentPool<TermComponent<Components>> *...> m_pools;
+            std::size_t m_lead;
+            std::size_t m_lead_size;
+            const std::vector<Entity> *m_entities = nullptr;       // Signatures, nullptr to check the sparse arrays
+            ComponentMask m_mask;
+            ComponentMask m_exclude;
+            ArchetypeStorage *m_archetypes = nullptr;               // Set over archetype storage, the pools are nullptr then
+            std::array<std::size_t, sizeof...(Components)> m_slots = {};
+            uint32_t m_since = 0;
+
+            template<std::size_t I>
+            using PoolAt = std::remove_pointer_t<std::tuple_element_t<I, decltype(m_pools)>>;
+
+            /**
+             * @brief Picks the smallest pool as the lead, the view is empty if a pool is missing
+             */
+            void selectLead() {
+                std::size_t sizes[sizeof...(Components)];
+                bool missing = [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return ((std::get<I>(m_pools) == nullptr) || ...);
+                }(std::index_sequence_for<Components...>{});
+
+                if (missing)
+                    return;
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    ((sizes[I] = std::get<I>(m_pools)->size()), ...);
+                }(std::index_sequence_for<Components...>{});
+
+                for (std::size_t i = 1; i < sizeof...(Components); i++) {
+                    if (sizes[i] < sizes[m_lead])
+                        m_lead = i;
+                }
+                m_lead_size = sizes[m_lead];
+            }
+
+            /**
+             * @brief Calls fn.template operator()<I>() with I being the lead pool index
+             */
+            template<typename Func>
+            void dispatchLead(Func &&fn) {
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    ((m_lead == I ? fn.template operator()<I>() : void()), ...);
+                }(std::index_sequence_for<Components...>{});
+            }
+
+            EntityID leadEntity(std::size_t dense_index) {
+                EntityID e = 0;
+
+                dispatchLead([&]<std::size_t Lead>() { e = std::get<Lead>(m_pools)->entityAt(dense_index); });
+                return e;
+            }
+
+            /**
+             * @brief Checks the candidate at a dense index of the lead pool against the whole query
+             */
+            bool acceptsLead(std::size_t dense_index) {
+                bool accepted = false;
+
+                dispatchLead([&]<std::size_t Lead>() {
+                    EntityID e = std::get<Lead>(m_pools)->entityAt(dense_index);
+
+                    accepted = e != NULL_ENTITY && containsIndex(entityIndex(e)) && passesFilters<Lead>(e, dense_index);
+                });
+                return accepted;
+            }
+
+            /**
+             * @brief Checks the Changed<T> / Added<T> terms of a candidate holding every viewed component
+             */
+            template<std::size_t Lead>
+            bool passesFilters(EntityID e, std::size_t dense_index) {
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return (passesFilter<Lead, I>(e, dense_index) && ...);
+                }(std::index_sequence_for<Components...>{});
+            }
+
+            template<std::size_t Lead, std::size_t I>
+            bool passesFilter(EntityID e, std::size_t dense_index) {
+                constexpr TermFilter filter = QueryTerm<std::tuple_element_t<I, std::tuple<Components...>>>::filter;
+
+                if constexpr (filter == TermFilter::NO_FILTER) {
+                    return true;
+                } else {
+                    PoolAt<I> &pool = *std::get<I>(m_pools);
+                    std::size_t index = I == Lead ? dense_index : pool.denseIndexOf(e);
+
+                    if constexpr (filter == TermFilter::CHANGED)
+                        return tickIsNewer(pool.changedTick(index), m_since);
+                    else
+                        return tickIsNewer(pool.addedTick(index), m_since);
+                }
+            }
+
+            /**
+             * @brief Fetches the component of pool I, the lead pool is read directly at its dense index
+             */
+            template<std::size_t Lead, std::size_t I>
+            auto &fetch(EntityID e, std::size_t dense_index) {
+                if constexpr (I == Lead)
+                    return std::get<I>(m_pools)->componentAt(dense_index);
+                else
+                    return std::get<I>(m_pools)->getComponent(e);
+            }
+
+            bool matches(const Archetype &archetype) const {
+                return archetype.size() != 0 && archetype.mask().containsAll(m_mask) && !archetype.mask().intersects(m_exclude);
+            }
+
+            void countArchetypes() {
+                m_lead_size = 0;
+                for (std::size_t i = 0; i < m_archetypes->archetypeCount(); i++) {
+                    if (matches(m_archetypes->archetypeAt(i)))
+                        m_lead_size += m_archetypes->archetypeAt(i).size();
+                }
+            }
+
+            /**
+             * @brief Calls fn on every row of the chunks [begin, end) of an archetype, columns are walked linearly
+             */
+            template<typename Func>
+            void eachChunks(Func &fn, Archetype &archetype, std::size_t begin, std::size_t end) {
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    std::size_t columns[] = {archetype.columnOf(m_slots[I])...};
+
+                    for (std::size_t chunk = begin; chunk < end; chunk++) {
+                        std::size_t count = archetype.chunkSize(chunk);
+                        EntityID *entities = archetype.entities(chunk);
+                        std::tuple<TermComponent<Components> *...> data(archetype.columnData<TermComponent<Components>>(chunk, columns[I])...);
+
+                        for (std::size_t i = 0; i < count; i++)
+                            std::invoke(fn, entities[i], std::get<I>(data)[i]...);
+                    }
+                }(std::index_sequence_for<Components...>{});
+            }
+
+            template<std::size_t Lead, typename Func>
+            void eachFrom(Func &fn, std::size_t begin, std::size_t end) {
+                PoolAt<Lead> &lead = *std::get<Lead>(m_pools);
+
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        EntityID e = lead.entityAt(i);
+
+                        if constexpr (PoolAt<Lead>::has_tombstones) {
+                            if (e == NULL_ENTITY)
+                                continue;
+                        }
+
+                        // Handles stored in a dense array are alive, the signature or the sparse arrays are enough
+                        if (m_entities != nullptr) {
+                            if (!containsIndex(entityIndex(e)))
+                                continue;
+                        } else if (!((I == Lead || std::get<I>(m_pools)->hasIndex(entityIndex(e))) && ...)) {
+                            continue;
+                        }
+                        if (!passesFilters<Lead>(e, i))
+                            continue;
+                        std::invoke(fn, e, fetch<Lead, I>(e, i)...);
+                    }
+                }(std::index_sequence_for<Components...>{});
+            }
+    };
+}
+
+#endif /* !VIEW_HPP_ */
@@ -0,0 +1,155 @@
+/*
+ *  WorldExecutor
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef WORLDEXECUTOR_HPP_
+    #define WORLDEXECUTOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "ECS.hpp"
+#include "ThreadPool.hpp"
+
+namespace ECS {
+
+    /**
+     * @brief Steps many independent worlds in parallel on one thread pool
+     *
+     * Each world is pinned to a worker, so that its data stays in that worker's caches from one
+     * step to the next. Idle workers still steal the worlds of busy ones, pinning is a preference.
+     * Worlds share nothing but the process-wide component type IDs, a world never runs on two threads at once.
+     */
+    class WorldExecutor {
+        public:
+            /**
+             * @brief Construct a new WorldExecutor object
+             *
+             * @param pool OPTIONAL the pool the worlds run on, it must outlive the executor
+             */
+            explicit WorldExecutor(ThreadPool &pool = ThreadPool::shared())
+            : m_pool(pool)
+            {}
+
+            WorldExecutor(const WorldExecutor &) = delete;
+            WorldExecutor &operator=(const WorldExecutor &) = delete;
+
+            /**
+             * @brief Adds a world, it's pinned to the worker with the fewest worlds
+             *
+             * The world must outlive its membership and must not be updated elsewhere while Update() runs
+             *
+             * @param world The world
+             * @return std::size_t The worker the world is pinned to
+             */
+            std::size_t addWorld(ECS &world) {
+                for (const Slot &it : m_worlds) {
+                    if (it.world == &world)
+                        return it.worker;
+                }
+
+                m_load.resize(m_pool.workerCount(), 0);
+
+                std::size_t worker = static_cast<std::size_t>(std::min_element(m_load.begin(), m_load.end()) - m_load.begin());
+
+                m_worlds.push_back(Slot{&world, worker});
+                m_load[worker]++;
+                return worker;
+            }
+
+            /**
+             * @brief Removes a world, the others keep their workers
+             *
+             * @param world The world
+             * @return true If the world was removed
+             * @return false If it wasn't part of the executor
+             */
+            bool removeWorld(ECS &world) {
+                auto it = std::find_if(m_worlds.begin(), m_worlds.end(), [&world](const Slot &slot) { return slot.world == &world; });
+
+                if (it == m_worlds.end())
+                    return false;
+                m_load[it->worker]--;
+                // Swap and pop, the order the worlds are queued in doesn't matter
+                *it = m_worlds.back();
+                m_worlds.pop_back();
+                return true;
+            }
+
+            /**
+             * @brief Pins a world to another worker
+             *
+             * @param world The world, added if it isn't part of the executor yet
+             * @param worker The worker's index, wrapped around the pool's worker count
+             */
+            void setAffinity(ECS &world, std::size_t worker) {
+                std::size_t current = addWorld(world);
+
+                worker %= m_load.size();
+                for (Slot &it : m_worlds) {
+                    if (it.world == &world)
+                        it.worker = worker;
+                }
+                m_load[current]--;
+                m_load[worker]++;
+            }
+
+            /**
+             * @brief Returns the amount of worlds stepped by Update()
+             */
+            std::size_t worldCount() const {
+                return m_worlds.size();
+            }
+
+            /**
+             * @brief Updates every world once, in parallel, returns when they're all done
+             *
+             * A world whose systems use the same pool, see ECS::setThreadPool(), runs them as nested tasks.
+             *
+             * @param msecs OPTIONAL the time elapsed since the previous call, given to every world
+             * @throw The first exception thrown by a world, the other worlds still complete their step
+             */
+            void Update(uint32_t msecs = 0) {
+                TaskGroup group;
+
+                for (const Slot &it : m_worlds) {
+                    ECS *world = it.world;
+
+                    m_pool.runOn(it.worker, group, [world, msecs]() { world->Update(msecs); });
+                }
+                m_pool.wait(group);
+            }
+
+        private:
+            struct Slot {
+                ECS *world;
+                std::size_t worker;
+            };
+
+            ThreadPool &m_pool;
+            std::vector<Slot> m_worlds;
+            std::vector<std::size_t> m_load;                            // Worlds pinned to each worker
+    };
+}
+
+#endif /* !WORLDEXECUTOR_HPP_ */
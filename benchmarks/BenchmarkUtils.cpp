@@ -0,0 +1,164 @@
+/*
+ *  BenchmarkUtils
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <malloc.h>
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+#include "BenchmarkUtils.hpp"
+
+namespace {
+    thread_local uint64_t t_count = 0;
+    thread_local uint64_t t_bytes = 0;
+    thread_local bool t_paused = false;
+
+    void *allocate(std::size_t size, std::size_t alignment) {
+        void *ptr = nullptr;
+
+        bench::Allocations::record(size);
+        if (alignment <= alignof(std::max_align_t))
+            ptr = std::malloc(size != 0 ? size : 1);
+#if defined(_WIN32)
+        else
+            ptr = _aligned_malloc(size != 0 ? size : 1, alignment);
+#else
+        else if (posix_memalign(&ptr, alignment, size != 0 ? size : 1) != 0)
+            ptr = nullptr;
+#endif
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        return ptr;
+    }
+
+    // Over-aligned blocks need their own free on Windows
+    void deallocateAligned(void *ptr) {
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+// Every allocation of the benchmarks goes through these, the pmr default resource included
+void *operator new(std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void *operator new[](std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { deallocateAligned(ptr); }
+
+namespace bench {
+
+    uint64_t Allocations::count() { return t_count; }
+    uint64_t Allocations::bytes() { return t_bytes; }
+
+    void Allocations::record(std::size_t size) {
+        if (t_paused)
+            return;
+        t_count++;
+        t_bytes += size;
+    }
+
+    Allocations::Pause::Pause()
+    : m_previous(t_paused)
+    {
+        t_paused = true;
+    }
+
+    Allocations::Pause::~Pause() {
+        t_paused = m_previous;
+    }
+
+#if defined(_WIN32)
+    std::size_t residentKiB() {
+        PROCESS_MEMORY_COUNTERS counters;
+
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+        return static_cast<std::size_t>(counters.WorkingSetSize) / 1024;
+    }
+
+    std::size_t peakResidentKiB() {
+        PROCESS_MEMORY_COUNTERS counters;
+
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+        return static_cast<std::size_t>(counters.PeakWorkingSetSize) / 1024;
+    }
+#else
+    std::size_t residentKiB() {
+        long pages = 0;
+        long resident = 0;
+        FILE *statm = std::fopen("/proc/self/statm", "r");
+
+        if (statm == nullptr)
+            return peakResidentKiB();
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(statm);
+        return static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+
+    std::size_t peakResidentKiB() {
+        struct rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+        // Linux reports KiB, macOS bytes
+#if defined(__APPLE__)
+        return static_cast<std::size_t>(usage.ru_maxrss) / 1024;
+#else
+        return static_cast<std::size_t>(usage.ru_maxrss);
+#endif
+    }
+#endif
+
+    Report::Report(benchmark::State &)
+    : m_allocations(Allocations::count()), m_bytes(Allocations::bytes())
+    {}
+
+    void Report::items(benchmark::State &state, int64_t items_per_iteration) {
+        state.SetItemsProcessed(state.iterations() * items_per_iteration);
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(Allocations::count() - m_allocations), benchmark::Counter::kAvgIterations);
+        state.counters["alloc_bytes"] = benchmark::Counter(static_cast<double>(Allocations::bytes() - m_bytes), benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1024);
+        state.counters["rss_kib"] = static_cast<double>(residentKiB());
+        state.counters["peak_rss_kib"] = static_cast<double>(peakResidentKiB());
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ *  BenchmarkUtils
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef BENCHMARKUTILS_HPP_
+    #define BENCHMARKUTILS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+
+namespace bench {
+
+    // Sizes the entity-count benchmarks run at, 1k to 1M
+    constexpr int64_t MIN_ENTITIES = 1 << 10;
+    constexpr int64_t MAX_ENTITIES = 1 << 20;
+
+    /**
+     * @brief Counts the heap allocations of the calling thread, the global operator new feeds it
+     */
+    class Allocations {
+        public:
+            static uint64_t count();
+            static uint64_t bytes();
+            static void record(std::size_t size);
+
+            /**
+             * @brief Stops counting on this thread until destroyed, for setup done inside the timed loop
+             */
+            class Pause {
+                public:
+                    Pause();
+                    ~Pause();
+
+                    Pause(const Pause &) = delete;
+                    Pause &operator=(const Pause &) = delete;
+
+                private:
+                    bool m_previous;
+            };
+    };
+
+    /**
+     * @brief Returns the resident set size of the process, in KiB
+     */
+    std::size_t residentKiB();
+
+    /**
+     * @brief Returns the peak resident set size of the process, in KiB
+     */
+    std::size_t peakResidentKiB();
+
+    /**
+     * @brief Measures a benchmark's allocations and memory, report() adds them to its counters
+     *
+     * bench::Report report(state);
+     * for (auto _ : state) { ... }
+     * report.items(state, N);
+     */
+    class Report {
+        public:
+            explicit Report(benchmark::State &state);
+
+            /**
+             * @brief Sets the throughput, allocations per iteration and RSS counters
+             *
+             * @param state The benchmark's state
+             * @param items_per_iteration Operations done by one iteration
+             */
+            void items(benchmark::State &state, int64_t items_per_iteration);
+
+        private:
+            uint64_t m_allocations;
+            uint64_t m_bytes;
+    };
+}
+
+#endif /* !BENCHMARKUTILS_HPP_ */
@@ -0,0 +1,139 @@
+/*
+ *  ComponentBenchmarks
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "ECS.hpp"
+#include "BenchmarkUtils.hpp"
+
+namespace {
+    struct Position { float x, y, z; };
+    struct Health { int value; };
+
+    using Components = ECS::ComponentList<Position, Health>;
+
+    // Adds then removes a component on N existing entities
+    void BM_AddRemoveComponent(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> entities;
+
+        ecs.registerComponent<Position>();
+        for (std::size_t i = 0; i < count; i++)
+            entities.push_back(ecs.entityCreate());
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            for (ECS::EntityID e : entities)
+                ecs.entityAddComponent<Position>(e);
+            for (ECS::EntityID e : entities)
+                ecs.entityRemoveComponent<Position>(e);
+        }
+        report.items(state, static_cast<int64_t>(count) * 2);
+    }
+    BENCHMARK(BM_AddRemoveComponent)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // Reads and writes through entityGetComponent(), in random order
+    void BM_GetComponentRandom(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> entities;
+        std::mt19937 rng(7);
+
+        ecs.registerComponent<Health>();
+        for (std::size_t i = 0; i < count; i++) {
+            entities.push_back(ecs.entityCreate());
+            ecs.entityAddComponent<Health>(entities.back()).value = static_cast<int>(i);
+        }
+        std::shuffle(entities.begin(), entities.end(), rng);
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            for (ECS::EntityID e : entities)
+                ecs.entityGetComponent<Health>(e).value++;
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_GetComponentRandom)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // Looks the pool up once per entity, through the runtime type IDs or a ComponentList
+    template<bool List>
+    void BM_GetPool(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> entities;
+
+        ecs.registerComponents<Components>();
+        for (std::size_t i = 0; i < count; i++) {
+            entities.push_back(ecs.entityCreate());
+            ecs.entityAddComponent<Health>(entities.back()).value = static_cast<int>(i);
+        }
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            for (ECS::EntityID e : entities) {
+                if constexpr (List)
+                    ecs.getPool<Health, Components>().getComponent(e).value++;
+                else
+                    ecs.getPool<Health>().getComponent(e).value++;
+            }
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_GetPool<false>)->Name("BM_GetPool/runtime")->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+    BENCHMARK(BM_GetPool<true>)->Name("BM_GetPool/list")->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // Mutates 1% of a pool (removals and additions) then syncs the sorted entity cache
+    void BM_ActiveEntitiesAfterMutation(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        std::size_t changes = std::max<std::size_t>(count / 100, 1);
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> entities;
+        std::mt19937 rng(3);
+
+        ecs.registerComponent<Position>();
+        for (std::size_t i = 0; i < count; i++) {
+            entities.push_back(ecs.entityCreate());
+            ecs.entityAddComponent<Position>(entities.back());
+        }
+        ecs.getPool<Position>().getActiveEntities();
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < changes; i++) {
+                ECS::EntityID e = entities[rng() % count];
+
+                ecs.entityRemoveComponent<Position>(e);
+                ecs.entityAddComponent<Position>(e);
+            }
+            benchmark::DoNotOptimize(ecs.getPool<Position>().getActiveEntities().data());
+        }
+        report.items(state, static_cast<int64_t>(changes));
+    }
+    BENCHMARK(BM_ActiveEntitiesAfterMutation)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+}
@@ -0,0 +1,181 @@
+/*
+ *  EntityBenchmarks
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "ECS.hpp"
+#include "BenchmarkUtils.hpp"
+
+namespace {
+    struct Position { float x, y, z; };
+    struct Velocity { float x, y, z; };
+
+    // Creates N entities, deletes a random half, then creates them again, recycled IDs included
+    void BM_CreateDeleteChurn(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> entities;
+        std::mt19937 rng(42);
+
+        for (std::size_t i = 0; i < count; i++)
+            entities.push_back(ecs.entityCreate());
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            std::shuffle(entities.begin(), entities.end(), rng);
+            for (std::size_t i = 0; i < count / 2; i++)
+                ecs.entityDelete(entities[i]);
+            for (std::size_t i = 0; i < count / 2; i++)
+                entities[i] = ecs.entityCreate();
+            benchmark::DoNotOptimize(entities.data());
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_CreateDeleteChurn)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // Creates N entities with two components each in a fresh world
+    void BM_CreateWithComponents(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            ECS::ECS ecs;
+
+            ecs.registerComponent<Position>();
+            ecs.registerComponent<Velocity>();
+            for (std::size_t i = 0; i < count; i++) {
+                ECS::EntityID e = ecs.entityCreate();
+
+                ecs.entityAddComponent<Position>(e);
+                ecs.entityAddComponent<Velocity>(e);
+            }
+            benchmark::DoNotOptimize(ecs.currentEntityCount());
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_CreateWithComponents)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // Bulk creation of N entities, then a bulk addition of one component
+    void BM_CreateBulk(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            ECS::ECS ecs;
+
+            ecs.registerComponent<Position>();
+            ecs.entityAddComponentBulk<Position>(ecs.entityCreateBulk(count));
+            benchmark::DoNotOptimize(ecs.currentEntityCount());
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_CreateBulk)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    template<int I>
+    struct Tag { int value; };
+
+    template<std::size_t... I>
+    void registerTags(ECS::ECS &ecs, std::size_t types, std::index_sequence<I...>) {
+        ((I < types ? (void)ecs.registerComponent<Tag<static_cast<int>(I)>>() : void()), ...);
+    }
+
+    template<std::size_t... I>
+    void addTags(ECS::ECS &ecs, ECS::EntityID e, std::size_t types, std::size_t first, std::size_t amount, std::index_sequence<I...>) {
+        ((I < types && (I + types - first) % types < amount ? (void)ecs.entityAddComponent<Tag<static_cast<int>(I)>>(e) : void()), ...);
+    }
+
+    // Deletes 16k entities holding 4 components each, with N component types registered
+    void BM_EntityDeleteWithTypes(benchmark::State &state) {
+        constexpr std::size_t count = 1 << 14;
+        std::size_t types = static_cast<std::size_t>(state.range(0));
+        std::vector<ECS::EntityID> entities(count);
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            ECS::ECS *ecs;
+            {
+                bench::Allocations::Pause pause;
+
+                ecs = new ECS::ECS();
+                registerTags(*ecs, types, std::make_index_sequence<64>{});
+                for (std::size_t i = 0; i < count; i++) {
+                    entities[i] = ecs->entityCreate();
+                    addTags(*ecs, entities[i], types, i % types, std::min<std::size_t>(4, types), std::make_index_sequence<64>{});
+                }
+            }
+            state.ResumeTiming();
+            for (ECS::EntityID e : entities)
+                ecs->entityDelete(e);
+            state.PauseTiming();
+            {
+                bench::Allocations::Pause pause;
+
+                delete ecs;
+            }
+            state.ResumeTiming();
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_EntityDeleteWithTypes)->Arg(1)->Arg(8)->Arg(32)->Arg(64);
+
+    // A world peaks at N entities with two components, keeps the first 1% of them, then gives the memory back
+    void BM_CompactAfterPeak(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            ECS::ECS *ecs;
+            {
+                bench::Allocations::Pause pause;
+
+                ecs = new ECS::ECS();
+                ecs->registerComponent<Position>();
+                ecs->registerComponent<Velocity>();
+
+                ECS::EntityRange peak = ecs->entityCreateBulk(count);
+
+                ecs->entityAddComponentBulk<Position>(peak);
+                ecs->entityAddComponentBulk<Velocity>(peak);
+                for (ECS::EntityID e : peak) {
+                    if (ECS::entityIndex(e) >= count / 100)
+                        ecs->entityDelete(e);
+                }
+            }
+            state.ResumeTiming();
+            ecs->compact();
+            state.PauseTiming();
+            {
+                bench::Allocations::Pause pause;
+
+                delete ecs;
+            }
+            state.ResumeTiming();
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_CompactAfterPeak)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+}
@@ -0,0 +1,151 @@
+/*
+ *  QueryBenchmarks
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "ECS.hpp"
+#include "BenchmarkUtils.hpp"
+
+namespace {
+    struct Position { float x, y, z; };
+    struct Velocity { float x, y, z; };
+    struct Sprite { int id; };
+    struct Node { ECS::EntityID parent; float local, world; };
+
+    // Half of the entities move, a third are drawn
+    void populate(ECS::ECS &ecs, std::size_t count) {
+        ecs.registerComponent<Position>();
+        ecs.registerComponent<Velocity>();
+        ecs.registerComponent<Sprite>();
+        for (std::size_t i = 0; i < count; i++) {
+            ECS::EntityID e = ecs.entityCreate();
+
+            ecs.entityAddComponent<Position>(e);
+            if (i % 2 == 0)
+                ecs.entityAddComponent<Velocity>(e);
+            if (i % 3 == 0)
+                ecs.entityAddComponent<Sprite>(e);
+        }
+    }
+
+    void BM_QueryAllOf(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+
+        populate(ecs, count);
+
+        bench::Report report(state);
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(ecs.getEntitiesByComponentsAllOf<Position, Velocity>());
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_QueryAllOf)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    void BM_QueryAnyOf(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> result;
+
+        populate(ecs, count);
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            ecs.getEntitiesByComponentsAnyOf<Velocity, Sprite>(result);
+            benchmark::DoNotOptimize(result.data());
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_QueryAnyOf)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // Iterates view<Position, Velocity>, each entity's components read and written in place
+    void BM_ViewIteration(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+
+        populate(ecs, count);
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            ecs.view<Position, Velocity>().each([](ECS::EntityID, Position &p, Velocity &v) {
+                p.x += v.x;
+                p.y += v.y;
+                p.z += v.z;
+            });
+        }
+        report.items(state, static_cast<int64_t>(count / 2));
+    }
+    BENCHMARK(BM_ViewIteration)->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+
+    // A random tree, children created after their parent, propagated top-down. The baseline looks
+    // each parent up through the ID stored in the component, the other sweeps the sorted hierarchy
+    template<bool Hierarchy>
+    void BM_PropagateTransforms(benchmark::State &state) {
+        std::size_t count = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+        std::vector<ECS::EntityID> entities;
+        std::mt19937 rng(11);
+
+        ecs.registerComponent<Node>();
+        for (std::size_t i = 0; i < count; i++)
+            entities.push_back(ecs.entityCreate());
+        // Pool order unrelated to the tree's, as after a level streamed in pieces
+        std::vector<ECS::EntityID> shuffled = entities;
+
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+        for (ECS::EntityID e : shuffled)
+            ecs.entityAddComponent<Node>(e) = Node{ECS::NULL_ENTITY, 1.0f, 0.0f};
+        for (std::size_t i = 1; i < count; i++) {
+            ECS::EntityID parent = entities[std::uniform_int_distribution<std::size_t>(0, i - 1)(rng)];
+
+            if constexpr (Hierarchy)
+                ecs.entitySetParent(entities[i], parent);
+            else
+                ecs.entityGetComponent<Node>(entities[i]).parent = parent;
+        }
+        if constexpr (Hierarchy)
+            ecs.sortHierarchy();
+
+        bench::Report report(state);
+
+        for (auto _ : state) {
+            if constexpr (Hierarchy) {
+                ecs.propagateHierarchy<Node>([](const Node *parent, Node &node) {
+                    node.world = parent ? parent->world + node.local : node.local;
+                });
+            } else {
+                for (ECS::EntityID e : entities) {
+                    Node &node = ecs.entityGetComponent<Node>(e);
+
+                    node.world = node.parent != ECS::NULL_ENTITY ? ecs.entityGetComponent<Node>(node.parent).world + node.local : node.local;
+                }
+            }
+        }
+        report.items(state, static_cast<int64_t>(count));
+    }
+    BENCHMARK(BM_PropagateTransforms<false>)->Name("BM_PropagateTransforms/lookup")->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+    BENCHMARK(BM_PropagateTransforms<true>)->Name("BM_PropagateTransforms/hierarchy")->RangeMultiplier(8)->Range(bench::MIN_ENTITIES, bench::MAX_ENTITIES);
+}
@@ -0,0 +1,108 @@
+/*
+ *  UpdateBenchmarks
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include "ECS.hpp"
+#include "BenchmarkUtils.hpp"
+
+namespace {
+    struct Position { float x, y, z; };
+    struct Velocity { float x, y, z; };
+
+    constexpr std::size_t UPDATE_ENTITIES = 1 << 14;
+
+    class MovementSystem : public ECS::ISystem {
+        public:
+            using reads = ECS::Reads<Velocity>;
+            using writes = ECS::Writes<Position>;
+
+            void Update(ECS::ECS &ecs, ECS::SystemID, uint32_t msecs) override {
+                float dt = static_cast<float>(msecs) / 1000.0f;
+
+                ecs.view<Position, Velocity>().each([dt](ECS::EntityID, Position &p, Velocity &v) {
+                    p.x += v.x * dt;
+                    p.y += v.y * dt;
+                    p.z += v.z * dt;
+                });
+            }
+    };
+
+    class ReadSystem : public ECS::ISystem {
+        public:
+            using reads = ECS::Reads<Position>;
+
+            void Update(ECS::ECS &ecs, ECS::SystemID, uint32_t) override {
+                float sum = 0;
+
+                ecs.view<Position>().each([&sum](ECS::EntityID, Position &p) { sum += p.x; });
+                benchmark::DoNotOptimize(sum);
+            }
+    };
+
+    void populate(ECS::ECS &ecs, std::size_t systems) {
+        ecs.registerComponent<Position>();
+        ecs.registerComponent<Velocity>();
+        for (std::size_t i = 0; i < UPDATE_ENTITIES; i++) {
+            ECS::EntityID e = ecs.entityCreate();
+
+            ecs.entityAddComponent<Position>(e);
+            ecs.entityAddComponent<Velocity>(e) = Velocity{1, 2, 3};
+        }
+        // Mostly readers, so that the parallel schedule has something to overlap
+        for (std::size_t i = 0; i < systems; i++) {
+            if (i % 4 == 0)
+                ecs.addSystem<MovementSystem>();
+            else
+                ecs.addSystem<ReadSystem>();
+        }
+    }
+
+    // A full Update() over 16k entities with N systems, one after another
+    void BM_UpdateSystems(benchmark::State &state) {
+        std::size_t systems = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+
+        populate(ecs, systems);
+
+        bench::Report report(state);
+
+        for (auto _ : state)
+            ecs.Update(16);
+        report.items(state, static_cast<int64_t>(systems));
+    }
+    BENCHMARK(BM_UpdateSystems)->RangeMultiplier(4)->Range(1, 256);
+
+    // Same, with the non-conflicting systems running together on the shared pool
+    void BM_UpdateSystemsParallel(benchmark::State &state) {
+        std::size_t systems = static_cast<std::size_t>(state.range(0));
+        ECS::ECS ecs;
+
+        populate(ecs, systems);
+        ecs.setThreadPool(&ECS::ThreadPool::shared());
+
+        bench::Report report(state);
+
+        for (auto _ : state)
+            ecs.Update(16);
+        report.items(state, static_cast<int64_t>(systems));
+    }
+    BENCHMARK(BM_UpdateSystemsParallel)->RangeMultiplier(4)->Range(1, 256)->UseRealTime();
+}
@@ -0,0 +1,79 @@
+/*
+ *  CommandBufferTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Velocity { float x = 0; };
+}
+
+TEST_CASE(commandsApplyAtFlush)
+{
+    ECS::ECS ecs;
+
+    ecs.registerComponent<Velocity>();
+
+    ECS::EntityID existing = ecs.entityCreate();
+    ECS::EntityID created = ecs.commands().entityCreate();
+
+    ecs.commands().entityAddComponent<Velocity>(created, Velocity{3});
+    ecs.commands().entityAddComponent<Velocity>(existing, Velocity{1});
+    CHECK(!ecs.entityIsActive(created));
+    CHECK(!ecs.entityHasComponent<Velocity>(existing));
+    ecs.flushCommands();
+    CHECK(ecs.entityIsActive(created));
+    CHECK(ecs.entityGetComponent<Velocity>(created).x == 3);
+    CHECK(ecs.entityGetComponent<Velocity>(existing).x == 1);
+
+    // A second add assigns, then the deletion comes last
+    ecs.commands().entityAddComponent<Velocity>(existing, Velocity{2});
+    ecs.commands().entityDelete(created);
+    ecs.flushCommands();
+    CHECK(ecs.entityGetComponent<Velocity>(existing).x == 2);
+    CHECK(!ecs.entityIsActive(created));
+    CHECK(ecs.commands().empty());
+}
+
+TEST_CASE(commandsRecycleOutsideUpdate)
+{
+    ECS::ECS ecs;
+    std::vector<ECS::EntityID> entities;
+
+    // Buffered churn between flushes, the caches refilled by each flush keep the table from growing
+    for (int round = 0; round < 50; round++) {
+        entities.clear();
+        for (int i = 0; i < 100; i++)
+            entities.push_back(ecs.commands().entityCreate());
+        ecs.flushCommands();
+        for (ECS::EntityID e : entities) {
+            CHECK(ecs.entityIsActive(e));
+            ecs.commands().entityDelete(e);
+        }
+        ecs.flushCommands();
+    }
+    CHECK(ecs.currentEntityCount() == 0);
+    for (ECS::EntityID e : entities)
+        CHECK(ECS::entityIndex(e) < 300);
+}
@@ -0,0 +1,99 @@
+/*
+ *  CompactTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Mass { int value = 0; };
+}
+
+TEST_CASE(compactKeepsPendingReservations)
+{
+    ECS::ECS ecs;
+
+    ecs.registerComponent<Mass>();
+    for (ECS::EntityID e : ecs.entityCreateBulk(1000))
+        ecs.entityDelete(e);
+
+    std::vector<ECS::EntityID> pending;
+
+    for (int i = 0; i < 100; i++)
+        pending.push_back(ecs.commands().entityCreate());
+    ecs.compact();
+    for (int i = 0; i < 10; i++)
+        ecs.commands().entityAddComponent<Mass>(pending[i], Mass{i});
+    ecs.flushCommands();
+    for (ECS::EntityID e : pending)
+        CHECK(ecs.entityIsActive(e));
+    for (int i = 0; i < 10; i++)
+        CHECK(ecs.entityGetComponent<Mass>(pending[i]).value == i);
+    ecs.compact();
+    CHECK(ecs.entityIsActive(ecs.entityCreate()));
+    CHECK(ecs.currentEntityCount() == 101);
+}
+
+TEST_CASE(compactKeepsReservationsPastTheTable)
+{
+    ECS::ECS ecs;
+
+    for (int i = 0; i < 100; i++)
+        ecs.commands().entityCreate();
+    ecs.compact();
+    ecs.flushCommands();
+    CHECK(ecs.currentEntityCount() == 100);
+}
+
+TEST_CASE(compactStepsKeepStaleHandlesStale)
+{
+    ECS::ECS ecs;
+    std::vector<ECS::EntityID> dropped;
+
+    ecs.registerComponent<Mass>();
+
+    ECS::EntityID kept = ecs.entityCreate();
+
+    ecs.entityAddComponent<Mass>(kept).value = 7;
+    for (ECS::EntityID e : ecs.entityCreateBulk(500)) {
+        ecs.entityAddComponent<Mass>(e);
+        dropped.push_back(e);
+    }
+    for (ECS::EntityID e : dropped)
+        ecs.entityDelete(e);
+    ECS::CompactPolicy policy;
+
+    // The dropped IDs take several steps
+    policy.step_entities = 64;
+    ecs.setCompactPolicy(policy);
+    while (!ecs.compactStep());
+    CHECK(ecs.entityGetComponent<Mass>(kept).value == 7);
+    for (int i = 0; i < 500; i++) {
+        ECS::EntityID e = ecs.entityCreate();
+
+        for (ECS::EntityID stale : dropped)
+            CHECK(e != stale);
+    }
+    for (ECS::EntityID stale : dropped)
+        CHECK(!ecs.entityIsActive(stale));
+}
@@ -0,0 +1,117 @@
+/*
+ *  ComponentTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Health { int value = 0; };
+
+    // A duplicate anywhere in the range must leave every entity untouched
+    void checkBulkDuplicates(ECS::StorageMode storage)
+    {
+        ECS::ECS ecs(0, false, storage);
+
+        ecs.registerComponent<Health>();
+
+        ECS::EntityRange range = ecs.entityCreateBulk(10);
+        std::vector<ECS::EntityID> entities(range.begin(), range.end());
+
+        entities.push_back(entities[3]);
+        CHECK_THROWS(ecs.entityAddComponentBulk<Health>(entities, Health{1}), ECS::ERROR::ComponentAlreadyAttached);
+        for (ECS::EntityID e : range)
+            CHECK(!ecs.entityHasComponent<Health>(e));
+        entities.pop_back();
+        ecs.entityAddComponentBulk<Health>(entities, Health{2});
+        for (ECS::EntityID e : range)
+            CHECK(ecs.entityGetComponent<Health>(e).value == 2);
+        CHECK_THROWS(ecs.entityAddComponentBulk<Health>(std::vector<ECS::EntityID>{entities[0]}), ECS::ERROR::ComponentAlreadyAttached);
+    }
+}
+
+TEST_CASE(bulkAttachRejectsDuplicatesSparseSet)
+{
+    checkBulkDuplicates(ECS::StorageMode::SPARSE_SET);
+}
+
+TEST_CASE(bulkAttachRejectsDuplicatesArchetype)
+{
+    checkBulkDuplicates(ECS::StorageMode::ARCHETYPE);
+}
+
+TEST_CASE(changeTickCoversLaterChanges)
+{
+    ECS::ECS ecs;
+
+    ecs.registerComponent<Health>();
+
+    std::vector<ECS::EntityID> entities;
+
+    for (int i = 0; i < 4; i++) {
+        entities.push_back(ecs.entityCreate());
+        ecs.entityAddComponent<Health>(entities.back());
+    }
+    ecs.Update();
+
+    uint32_t tick = ecs.changeTick();
+
+    ecs.entityMarkChanged<Health>(entities[2]).value = 5;
+
+    auto changed = ecs.view<ECS::Changed<Health>>();
+    std::vector<ECS::EntityID> seen;
+
+    changed.since(tick);
+    for (auto [e, health] : changed) {
+        CHECK(health.value == 5);
+        seen.push_back(e);
+    }
+    CHECK(seen == std::vector<ECS::EntityID>{entities[2]});
+}
+
+TEST_CASE(removalsAreReported)
+{
+    ECS::ECS ecs;
+
+    ecs.registerComponent<Health>();
+
+    ECS::EntityID kept = ecs.entityCreate();
+    ECS::EntityID removed = ecs.entityCreate();
+    ECS::EntityID deleted = ecs.entityCreate();
+
+    for (ECS::EntityID e : {kept, removed, deleted})
+        ecs.entityAddComponent<Health>(e);
+    ecs.entityRemoveComponent<Health>(removed);
+    ecs.entityDelete(deleted);
+    CHECK(ecs.getEntitiesByComponentsAllOf<Health>() == std::vector<ECS::EntityID>{kept});
+
+    std::span<const ECS::EntityID> removals = ecs.getPool<Health>().removedSince(0);
+
+    CHECK((std::vector<ECS::EntityID>(removals.begin(), removals.end()) == std::vector<ECS::EntityID>{removed, deleted}));
+
+    // Attached again, the entity is back in the sorted cache, the removal stays reported
+    ecs.entityAddComponent<Health>(removed);
+    ecs.entityRemoveComponent<Health>(kept);
+    CHECK(ecs.getEntitiesByComponentsAllOf<Health>() == std::vector<ECS::EntityID>{removed});
+    CHECK(ecs.getPool<Health>().removedSince(0).size() == 3);
+}
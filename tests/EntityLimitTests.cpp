@@ -0,0 +1,63 @@
+/*
+ *  EntityLimitTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+// Built with a narrow entity index, see tests/CMakeLists.txt, so that the limit is reachable
+
+TEST_CASE(entityLimitKeepsNullEntityFree)
+{
+    ECS::ECS ecs;
+
+    ecs.entityCreateBulk(ECS::ENTITY_INDEX_LIMIT - 1);
+    CHECK_THROWS(ecs.entityCreateBulk(2), ECS::ERROR::EntityLimitReached);
+
+    ECS::EntityID last = ecs.entityCreate();
+
+    CHECK(ECS::entityIndex(last) == ECS::ENTITY_INDEX_LIMIT - 1);
+    CHECK(last != ECS::NULL_ENTITY);
+    CHECK_THROWS(ecs.entityCreate(), ECS::ERROR::EntityLimitReached);
+    CHECK_THROWS(ecs.entityCreateBulk(1), ECS::ERROR::EntityLimitReached);
+    CHECK_THROWS(ecs.commands().entityCreate(), ECS::ERROR::EntityLimitReached);
+    CHECK(!ecs.entityIsActive(ECS::NULL_ENTITY));
+}
+
+TEST_CASE(generationsWrapAtTheTopIndex)
+{
+    ECS::ECS ecs;
+
+    ecs.entityCreateBulk(ECS::ENTITY_INDEX_LIMIT - 1);
+
+    ECS::EntityID last = ecs.entityCreate();
+
+    // Every generation of the top index once, the handle wraps without ever matching NULL_ENTITY
+    for (uint32_t i = 0; i <= ECS::ENTITY_GENERATION_MASK; i++) {
+        ecs.entityDelete(last);
+        last = ecs.entityCreate();
+        CHECK(last != ECS::NULL_ENTITY);
+        CHECK(ecs.entityIsActive(last));
+        // Drops the deletion log
+        if (i % 4096 == 0)
+            ecs.Update();
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ *  EntityTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Position { float x, y; };
+
+    // A deleted entity's handle must not reach the entity that recycled its index
+    void checkStaleHandles(ECS::StorageMode storage)
+    {
+        ECS::ECS ecs(0, false, storage);
+
+        ecs.registerComponent<Position>();
+
+        ECS::EntityID stale = ecs.entityCreate();
+
+        ecs.entityAddComponent<Position>(stale) = Position{1, 1};
+        ecs.entityDelete(stale);
+
+        ECS::EntityID fresh = ecs.entityCreate();
+
+        CHECK(ECS::entityIndex(fresh) == ECS::entityIndex(stale));
+        CHECK(fresh != stale);
+        CHECK(!ecs.entityIsActive(stale));
+        CHECK(ecs.entityIsActive(fresh));
+        CHECK(!ecs.entityHasComponent<Position>(stale));
+        CHECK_THROWS(ecs.entityAddComponent<Position>(stale), ECS::ERROR::InvalidEntityID);
+        CHECK(!ecs.entityHasComponent<Position>(fresh));
+        ecs.entityAddComponent<Position>(fresh) = Position{2, 2};
+        CHECK_THROWS(ecs.entityGetComponent<Position>(stale), ECS::ERROR::InvalidEntityID);
+        CHECK_THROWS(ecs.entityRemoveComponent<Position>(stale), ECS::ERROR::InvalidEntityID);
+        CHECK_THROWS(ecs.entityAddComponentBulk<Position>(std::vector<ECS::EntityID>{stale}), ECS::ERROR::InvalidEntityID);
+        CHECK(ecs.entityGetComponent<Position>(fresh).x == 2);
+
+        // A live entity without the component
+        ECS::EntityID bare = ecs.entityCreate();
+
+        CHECK_THROWS(ecs.entityGetComponent<Position>(bare), ECS::ERROR::ComponentNotAttached);
+        ecs.entityRemoveComponent<Position>(bare);
+        ecs.entityDelete(bare);
+        ecs.entityDelete(stale);
+        CHECK(ecs.entityIsActive(fresh));
+        CHECK(ecs.currentEntityCount() == 1);
+    }
+}
+
+TEST_CASE(staleHandlesSparseSet)
+{
+    checkStaleHandles(ECS::StorageMode::SPARSE_SET);
+}
+
+TEST_CASE(staleHandlesArchetype)
+{
+    checkStaleHandles(ECS::StorageMode::ARCHETYPE);
+}
+
+TEST_CASE(nullEntityIsNeverActive)
+{
+    ECS::ECS ecs;
+
+    CHECK(!ecs.entityIsActive(ECS::NULL_ENTITY));
+    for (int i = 0; i < 100; i++)
+        CHECK(ecs.entityCreate() != ECS::NULL_ENTITY);
+    CHECK(!ecs.entityIsActive(ECS::NULL_ENTITY));
+}
+
+TEST_CASE(bulkCreateAndGroups)
+{
+    ECS::ECS ecs;
+    ECS::EntityRange range = ecs.entityCreateBulk(50, static_cast<ECS::EntityGroup>(1));
+
+    CHECK(ecs.currentEntityCount() == 50);
+    CHECK(ecs.getEntityGroup(static_cast<ECS::EntityGroup>(1)).size() == 50);
+    for (ECS::EntityID e : range)
+        CHECK(ecs.entityIsActive(e));
+    ecs.entitySetGroup(*range.begin(), ECS::NONE);
+    ecs.entityDelete(*std::next(range.begin()));
+    CHECK(ecs.getEntityGroup(static_cast<ECS::EntityGroup>(1)).size() == 48);
+}
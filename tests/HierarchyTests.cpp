@@ -0,0 +1,128 @@
+/*
+ *  HierarchyTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Transform { float local = 0; float world = 0; };
+
+    std::vector<ECS::EntityID> childrenOf(ECS::ECS &ecs, ECS::EntityID e)
+    {
+        std::vector<ECS::EntityID> children;
+
+        ecs.entityForEachChild(e, [&children](ECS::EntityID child) { children.push_back(child); });
+        return children;
+    }
+
+    void propagate(ECS::ECS &ecs)
+    {
+        ecs.propagateHierarchy<Transform>([](const Transform *parent, Transform &node) {
+            node.world = (parent ? parent->world : 0) + node.local;
+        });
+    }
+}
+
+TEST_CASE(parentsAndChildren)
+{
+    ECS::ECS ecs;
+    ECS::EntityID root = ecs.entityCreate();
+    ECS::EntityID a = ecs.entityCreate();
+    ECS::EntityID b = ecs.entityCreate();
+    ECS::EntityID leaf = ecs.entityCreate();
+
+    ecs.entitySetParent(a, root);
+    ecs.entitySetParent(b, root);
+    ecs.entitySetParent(leaf, a);
+    CHECK(ecs.entityGetParent(leaf) == a);
+    CHECK(ecs.entityGetParent(root) == ECS::NULL_ENTITY);
+    CHECK((childrenOf(ecs, root) == std::vector<ECS::EntityID>{a, b}));
+    CHECK_THROWS(ecs.entitySetParent(root, leaf), ECS::ERROR::HierarchyCycle);
+    CHECK_THROWS(ecs.entitySetParent(a, a), ECS::ERROR::HierarchyCycle);
+
+    ecs.entitySetParent(leaf, b);
+    CHECK(childrenOf(ecs, a).empty());
+    CHECK(childrenOf(ecs, b) == std::vector<ECS::EntityID>{leaf});
+
+    // Deleting a parent makes its children roots
+    ecs.entityDelete(b);
+    CHECK(ecs.entityGetParent(leaf) == ECS::NULL_ENTITY);
+    CHECK(childrenOf(ecs, root) == std::vector<ECS::EntityID>{a});
+}
+
+TEST_CASE(deleteSubtree)
+{
+    ECS::ECS ecs;
+    ECS::EntityID other = ecs.entityCreate();
+    ECS::EntityID root = ecs.entityCreate();
+    std::vector<ECS::EntityID> subtree{root};
+
+    for (int i = 0; i < 20; i++) {
+        subtree.push_back(ecs.entityCreate());
+        ecs.entitySetParent(subtree.back(), subtree[i / 3]);
+    }
+
+    ECS::EntityID sibling = ecs.entityCreate();
+
+    ecs.entitySetParent(sibling, other);
+    ecs.entitySetParent(root, other);
+    CHECK(ecs.entityDeleteSubtree(root) == subtree.size());
+    for (ECS::EntityID e : subtree)
+        CHECK(!ecs.entityIsActive(e));
+    CHECK(ecs.currentEntityCount() == 2);
+    CHECK(childrenOf(ecs, other) == std::vector<ECS::EntityID>{sibling});
+    CHECK(ecs.getPool<ECS::Relationship>().count() == 2);
+
+    // Outside of the hierarchy only the entity itself goes
+    CHECK(ecs.entityDeleteSubtree(ecs.entityCreate()) == 1);
+    CHECK(ecs.entityDeleteSubtree(root) == 0);
+}
+
+TEST_CASE(propagateParentsFirst)
+{
+    ECS::ECS ecs;
+
+    ecs.registerComponent<Transform>();
+
+    ECS::EntityID a = ecs.entityCreate();
+    ECS::EntityID b = ecs.entityCreate();
+    ECS::EntityID c = ecs.entityCreate();
+    ECS::EntityID d = ecs.entityCreate();
+
+    // Children created before their parents, so that the pool's order differs from the hierarchy's
+    for (ECS::EntityID e : {d, c, b, a})
+        ecs.entityAddComponent<Transform>(e) = Transform{1, 0};
+    ecs.entitySetParent(b, a);
+    ecs.entitySetParent(c, b);
+    ecs.entitySetParent(d, a);
+    propagate(ecs);
+    CHECK(ecs.entityGetComponent<Transform>(a).world == 1);
+    CHECK(ecs.entityGetComponent<Transform>(c).world == 3);
+    CHECK(ecs.entityGetComponent<Transform>(d).world == 2);
+
+    ecs.entitySetParent(c, d);
+    ecs.entityGetComponent<Transform>(d).local = 5;
+    propagate(ecs);
+    CHECK(ecs.entityGetComponent<Transform>(c).world == 7);
+}
@@ -0,0 +1,249 @@
+/*
+ *  ParallelTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Position { float x = 0; };
+    struct Velocity { float x = 0; };
+    struct Health { int value = 0; };
+    struct Counter { int value = 0; };
+
+    // What the systems saw, systems are default constructed
+    std::mutex t_mutex;
+    std::vector<int> t_order;
+    std::atomic<int> t_arrived{0};
+    std::atomic<bool> t_met{true};
+    std::atomic<bool> t_exclusive_running{false};
+    std::atomic<bool> t_overlapped{false};
+
+    void record(int system)
+    {
+        std::lock_guard<std::mutex> lock(t_mutex);
+
+        t_order.push_back(system);
+    }
+
+    // Waits for the other system of the stage, a second at most
+    void meet()
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        t_arrived++;
+        while (t_arrived.load() < 2) {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(1)) {
+                t_met = false;
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    template<int N>
+    class PositionWriter : public ECS::ISystem {
+        public:
+            using writes = ECS::Writes<Position>;
+
+            void Update(ECS::ECS &, ECS::SystemID, uint32_t) override { record(N); }
+    };
+
+    template<typename Written, bool Meet>
+    class PositionReader : public ECS::ISystem {
+        public:
+            using reads = ECS::Reads<Position>;
+            using writes = ECS::Writes<Written>;
+
+            void Update(ECS::ECS &, ECS::SystemID, uint32_t) override
+            {
+                if (t_exclusive_running)
+                    t_overlapped = true;
+                record(std::is_same_v<Written, Velocity> ? 1 : 2);
+                if (Meet)
+                    meet();
+            }
+    };
+
+    class ExclusiveSystem : public ECS::ISystem {
+        public:
+            void Update(ECS::ECS &, ECS::SystemID, uint32_t) override
+            {
+                t_exclusive_running = true;
+                record(0);
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                t_exclusive_running = false;
+            }
+    };
+
+    template<typename T>
+    class Spawner : public ECS::ISystem {
+        public:
+            using writes = ECS::Writes<T>;
+
+            void Update(ECS::ECS &ecs, ECS::SystemID, uint32_t) override
+            {
+                ECS::CommandBuffer &commands = ecs.commands();
+
+                for (int i = 0; i < 100; i++)
+                    commands.entityAddComponent<T>(commands.entityCreate());
+            }
+    };
+
+    void resetRecords()
+    {
+        t_order.clear();
+        t_arrived = 0;
+        t_met = true;
+        t_exclusive_running = false;
+        t_overlapped = false;
+    }
+}
+
+TEST_CASE(conflictingSystemsKeepRegistrationOrder)
+{
+    ECS::ThreadPool pool(2);
+    ECS::ECS ecs;
+
+    resetRecords();
+    ecs.addSystem<PositionWriter<0>>();
+    ecs.addSystem<PositionWriter<1>>();
+    ecs.addSystem<PositionWriter<2>>();
+    ecs.setThreadPool(&pool);
+    for (int i = 0; i < 10; i++)
+        ecs.Update();
+    CHECK(t_order.size() == 30);
+    for (std::size_t i = 0; i < t_order.size(); i++)
+        CHECK(t_order[i] == static_cast<int>(i % 3));
+}
+
+TEST_CASE(independentSystemsShareAStage)
+{
+    ECS::ThreadPool pool(2);
+    ECS::ECS ecs;
+
+    resetRecords();
+    ecs.addSystem<PositionReader<Velocity, true>>();
+    ecs.addSystem<PositionReader<Health, true>>();
+    ecs.setThreadPool(&pool);
+    ecs.Update();
+    // Each one waited for the other, so they ran at the same time
+    CHECK(t_met);
+    CHECK(t_order.size() == 2);
+}
+
+TEST_CASE(exclusiveSystemsRunAlone)
+{
+    ECS::ThreadPool pool(2);
+    ECS::ECS ecs;
+
+    resetRecords();
+    ecs.addSystem<PositionReader<Velocity, false>>();
+    ecs.addSystem<ExclusiveSystem>();
+    ecs.addSystem<PositionReader<Health, false>>();
+    ecs.setThreadPool(&pool);
+    for (int i = 0; i < 5; i++)
+        ecs.Update();
+    CHECK(!t_overlapped);
+    CHECK(t_order.size() == 15);
+    for (std::size_t i = 0; i < t_order.size(); i++)
+        CHECK((t_order[i] == std::vector<int>{1, 0, 2}[i % 3]));
+}
+
+TEST_CASE(parallelSystemsRecordCommands)
+{
+    ECS::ThreadPool pool(2);
+    ECS::ECS ecs;
+
+    ecs.registerComponent<Velocity>();
+    ecs.registerComponent<Health>();
+    ecs.addSystem<Spawner<Velocity>>();
+    ecs.addSystem<Spawner<Health>>();
+    ecs.setThreadPool(&pool);
+    for (int i = 0; i < 3; i++)
+        ecs.Update();
+    CHECK(ecs.currentEntityCount() == 600);
+    CHECK(ecs.getEntitiesByComponentsAllOf<Velocity>().size() == 300);
+    CHECK(ecs.getEntitiesByComponentsAllOf<Health>().size() == 300);
+    CHECK((ecs.getEntitiesByComponentsAnyOf<Velocity, Health>().size() == 600));
+}
+
+TEST_CASE(poolParallelForEachVisitsEachComponentOnce)
+{
+    ECS::ThreadPool pool(3);
+    ECS::ECS ecs;
+    std::vector<ECS::EntityID> entities;
+
+    ecs.registerComponent<Counter>();
+    for (int i = 0; i < 10000; i++) {
+        entities.push_back(ecs.entityCreate());
+        ecs.entityAddComponent<Counter>(entities.back());
+    }
+    // Removals shuffle the dense array
+    for (std::size_t i = 0; i < entities.size(); i += 7)
+        ecs.entityDelete(entities[i]);
+
+    std::atomic<std::size_t> visited{0};
+
+    ecs.getPool<Counter>().parallelForEach([&visited](ECS::EntityID, Counter &c) {
+        c.value++;
+        visited++;
+    }, 64, pool);
+    CHECK(visited == ecs.getPool<Counter>().size());
+    for (std::size_t i = 0; i < entities.size(); i++) {
+        if (i % 7 != 0)
+            CHECK(ecs.entityGetComponent<Counter>(entities[i]).value == 1);
+    }
+}
+
+TEST_CASE(viewParallelForEachVisitsEachMatchOnce)
+{
+    for (ECS::StorageMode storage : {ECS::StorageMode::SPARSE_SET, ECS::StorageMode::ARCHETYPE}) {
+        ECS::ThreadPool pool(3);
+        ECS::ECS ecs(0, false, storage);
+        std::vector<ECS::EntityID> entities;
+
+        ecs.registerComponent<Counter>();
+        ecs.registerComponent<Health>();
+        for (int i = 0; i < 5000; i++) {
+            entities.push_back(ecs.entityCreate());
+            ecs.entityAddComponent<Counter>(entities.back());
+            if (i % 3 == 0)
+                ecs.entityAddComponent<Health>(entities.back());
+        }
+
+        std::atomic<std::size_t> visited{0};
+
+        ecs.view<Counter, Health>().parallelForEach([&visited](ECS::EntityID, Counter &c, Health &) {
+            c.value++;
+            visited++;
+        }, 128, pool);
+        CHECK(visited == (5000 + 2) / 3);
+        for (std::size_t i = 0; i < entities.size(); i++)
+            CHECK(ecs.entityGetComponent<Counter>(entities[i]).value == (i % 3 == 0 ? 1 : 0));
+    }
+}
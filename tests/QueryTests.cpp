@@ -0,0 +1,208 @@
+/*
+ *  QueryTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Position { float x = 0; };
+    struct Velocity { float x = 0; };
+    struct Frozen { int reason = 0; };
+    struct Depth { int value = 0; };
+}
+
+template<>
+struct ECS::ComponentTraits<Depth> {
+    static constexpr bool pointer_stable = true;
+};
+
+namespace {
+    // Entity i has Position if i % 2 == 0, Velocity if i % 3 == 0, Frozen if i % 5 == 0
+    std::vector<ECS::EntityID> populate(ECS::ECS &ecs, int count)
+    {
+        std::vector<ECS::EntityID> entities;
+
+        ecs.registerComponent<Position>();
+        ecs.registerComponent<Velocity>();
+        ecs.registerComponent<Frozen>();
+        for (int i = 0; i < count; i++) {
+            ECS::EntityID e = ecs.entityCreate();
+
+            entities.push_back(e);
+            if (i % 2 == 0)
+                ecs.entityAddComponent<Position>(e);
+            if (i % 3 == 0)
+                ecs.entityAddComponent<Velocity>(e);
+            if (i % 5 == 0)
+                ecs.entityAddComponent<Frozen>(e);
+        }
+        return entities;
+    }
+
+    template<typename Predicate>
+    std::vector<ECS::EntityID> expected(const std::vector<ECS::EntityID> &entities, Predicate predicate)
+    {
+        std::vector<ECS::EntityID> result;
+
+        for (std::size_t i = 0; i < entities.size(); i++) {
+            if (predicate(static_cast<int>(i)))
+                result.push_back(entities[i]);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    void checkQueries(ECS::StorageMode storage)
+    {
+        ECS::ECS ecs(0, false, storage);
+        std::vector<ECS::EntityID> entities = populate(ecs, 300);
+
+        CHECK(ecs.getEntitiesByComponentsAllOf<Position>(ECS::NoneOf<Frozen>{})
+            == expected(entities, [](int i) { return i % 2 == 0 && i % 5 != 0; }));
+        CHECK((ecs.getEntitiesByComponentsAllOf<Position, Velocity>(ECS::NoneOf<Frozen>{})
+            == expected(entities, [](int i) { return i % 6 == 0 && i % 5 != 0; })));
+
+        std::vector<ECS::EntityID> seen;
+
+        for (auto [e, position] : ecs.view<Position>(ECS::NoneOf<Velocity, Frozen>{})) {
+            (void)position;
+            seen.push_back(e);
+        }
+        std::sort(seen.begin(), seen.end());
+        CHECK(seen == expected(entities, [](int i) { return i % 2 == 0 && i % 3 != 0 && i % 5 != 0; }));
+
+        std::vector<ECS::EntityID> any = ecs.getEntitiesByComponentsAnyOf<Position, Velocity, Frozen>();
+
+        CHECK(any == expected(entities, [](int i) { return i % 2 == 0 || i % 3 == 0 || i % 5 == 0; }));
+
+        // The buffer is reused, its previous content dropped
+        std::vector<ECS::EntityID> buffer(1000, ECS::NULL_ENTITY);
+
+        ecs.getEntitiesByComponentsAnyOf<Velocity, Frozen>(buffer);
+        CHECK(buffer == expected(entities, [](int i) { return i % 3 == 0 || i % 5 == 0; }));
+    }
+}
+
+TEST_CASE(noneOfAndAnyOfSparseSet)
+{
+    checkQueries(ECS::StorageMode::SPARSE_SET);
+}
+
+TEST_CASE(noneOfAndAnyOfArchetype)
+{
+    checkQueries(ECS::StorageMode::ARCHETYPE);
+}
+
+TEST_CASE(anyOfFollowsRemovals)
+{
+    ECS::ECS ecs;
+    std::vector<ECS::EntityID> entities = populate(ecs, 100);
+
+    for (std::size_t i = 0; i < entities.size(); i += 4)
+        ecs.entityDelete(entities[i]);
+    for (std::size_t i = 1; i < entities.size(); i += 4) {
+        if (ecs.entityHasComponent<Velocity>(entities[i]))
+            ecs.entityRemoveComponent<Velocity>(entities[i]);
+    }
+    CHECK((ecs.getEntitiesByComponentsAnyOf<Position, Velocity>()
+        == expected(entities, [](int i) { return i % 4 != 0 && (i % 2 == 0 || (i % 3 == 0 && i % 4 != 1)); })));
+}
+
+TEST_CASE(sortByOrdersTheDenseArray)
+{
+    ECS::ECS ecs;
+    std::mt19937 rng(7);
+    std::vector<ECS::EntityID> entities;
+
+    ecs.registerComponent<Position>();
+    ecs.registerComponent<Depth>();
+    for (int i = 0; i < 500; i++) {
+        entities.push_back(ecs.entityCreate());
+        ecs.entityAddComponent<Position>(entities.back()).x = static_cast<float>(rng() % 1000);
+        ecs.entityAddComponent<Depth>(entities.back()).value = static_cast<int>(rng() % 1000);
+    }
+    // Tombstones in the pointer-stable pool
+    for (std::size_t i = 0; i < entities.size(); i += 9)
+        ecs.entityRemoveComponent<Depth>(entities[i]);
+
+    ECS::ComponentPool<Position> &positions = ecs.getPool<Position>();
+    ECS::ComponentPool<Depth> &depths = ecs.getPool<Depth>();
+
+    positions.sortBy([](const Position &a, const Position &b) { return a.x < b.x; });
+    for (std::size_t i = 1; i < positions.size(); i++)
+        CHECK(positions.componentAt(i - 1).x <= positions.componentAt(i).x);
+    depths.sortBy([](ECS::EntityID a, ECS::EntityID b) { return a > b; });
+    for (std::size_t i = 1; i < depths.size(); i++)
+        CHECK(depths.entityAt(i - 1) > depths.entityAt(i));
+
+    // Lookups still find each entity's own component
+    for (ECS::EntityID e : entities) {
+        CHECK(positions.componentAt(positions.denseIndexOf(e)).x == ecs.entityGetComponent<Position>(e).x);
+        CHECK(ecs.entityHasComponent<Depth>(e) == depths.hasComponent(e));
+    }
+    CHECK((ecs.getEntitiesByComponentsAllOf<Position, Depth>().size() == 500 - (500 + 8) / 9));
+}
+
+TEST_CASE(alignPoolsFollowsTheLead)
+{
+    ECS::ECS ecs;
+    std::vector<ECS::EntityID> entities;
+
+    ecs.registerComponent<Position>();
+    ecs.registerComponent<Velocity>();
+    for (int i = 0; i < 1000; i++) {
+        entities.push_back(ecs.entityCreate());
+        // Velocity is added in the reverse order, a third of the entities don't get one
+        ecs.entityAddComponent<Position>(entities.back()).x = static_cast<float>(i);
+    }
+    for (int i = 999; i >= 0; i--) {
+        if (i % 3 != 0)
+            ecs.entityAddComponent<Velocity>(entities[i]).x = static_cast<float>(i);
+    }
+
+    // Spread over several calls, each visiting 64 lead cells at most
+    std::size_t calls = 1;
+
+    while (!ecs.alignPools<Position, Velocity>(64))
+        calls++;
+    CHECK(calls > 1);
+
+    ECS::ComponentPool<Position> &positions = ecs.getPool<Position>();
+    ECS::ComponentPool<Velocity> &velocities = ecs.getPool<Velocity>();
+    std::size_t cell = 0;
+
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        ECS::EntityID e = positions.entityAt(i);
+
+        if (!velocities.hasComponent(e))
+            continue;
+        CHECK(velocities.entityAt(cell) == e);
+        CHECK(velocities.componentAt(cell).x == positions.componentAt(i).x);
+        cell++;
+    }
+    CHECK(cell == velocities.size());
+    CHECK((ecs.alignPools<Position, Velocity>()));
+}
@@ -0,0 +1,174 @@
+/*
+ *  SimdTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <array>
+#include <vector>
+
+#include "ECS.hpp"
+#include "Simd.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Position { float x = 0, y = 0, z = 0; };
+    struct Velocity { float x = 0, y = 0, z = 0; };
+
+    // The levels force() accepts on this machine, the narrowest first
+    std::vector<ECS::SimdLevel> runnableLevels()
+    {
+        ECS::SimdLevel detected = ECS::detectSimdLevel();
+
+        if (detected == ECS::SimdLevel::NEON)
+            return {ECS::SimdLevel::NEON};
+
+        std::vector<ECS::SimdLevel> levels;
+
+        for (ECS::SimdLevel level : {ECS::SimdLevel::SCALAR, ECS::SimdLevel::SSE, ECS::SimdLevel::AVX2, ECS::SimdLevel::AVX512}) {
+            if (level <= detected)
+                levels.push_back(level);
+        }
+        return levels;
+    }
+}
+
+template<>
+struct ECS::ComponentTraits<Position> {
+    static constexpr bool split_storage = true;
+};
+
+template<>
+struct ECS::ComponentTraits<Velocity> {
+    static constexpr bool split_storage = true;
+};
+
+TEST_CASE(simdForceKeepsToDetectedLevels)
+{
+    ECS::SimdLevel detected = ECS::detectSimdLevel();
+
+    ECS::SimdDispatch::force(ECS::SimdLevel::SCALAR);
+    CHECK(ECS::simdLevel() == (detected == ECS::SimdLevel::NEON ? detected : ECS::SimdLevel::SCALAR));
+    ECS::SimdDispatch::force(ECS::SimdLevel::AVX512);
+    CHECK(ECS::SimdDispatch::level() == detected);
+    CHECK(ECS::simdLanes(ECS::SimdLevel::SSE) == 4);
+    CHECK(ECS::simdLanes(ECS::SimdLevel::AVX2) == 8);
+    ECS::SimdDispatch::force(detected);
+}
+
+TEST_CASE(integrateBatchMatchesScalar)
+{
+    // Odd sizes end on a partial batch on every path
+    for (std::size_t count : {0u, 1u, 3u, 7u, 17u, 33u, 101u}) {
+        std::vector<float> rates(count);
+        std::vector<float> expected(count);
+
+        for (std::size_t i = 0; i < count; i++) {
+            rates[i] = static_cast<float>(i % 13) - 6.0f;
+            expected[i] = static_cast<float>(i) + rates[i] * 0.5f;
+        }
+        for (ECS::SimdLevel level : runnableLevels()) {
+            std::vector<float> values(count + 1);
+
+            for (std::size_t i = 0; i < count; i++)
+                values[i] = static_cast<float>(i);
+            values[count] = 42.0f;
+            ECS::SimdDispatch::force(level);
+            ECS::integrateBatch(std::span<float>(values.data(), count), rates, 0.5f);
+            for (std::size_t i = 0; i < count; i++)
+                CHECK(values[i] == expected[i]);
+            // Past the end is left alone
+            CHECK(values[count] == 42.0f);
+        }
+    }
+    ECS::SimdDispatch::force(ECS::detectSimdLevel());
+}
+
+TEST_CASE(cullAabbBatchMatchesScalar)
+{
+    constexpr std::size_t count = 37;
+    std::array<float, 3> view_min{0.0f, 0.0f, 0.0f};
+    std::array<float, 3> view_max{10.0f, 10.0f, 10.0f};
+    std::vector<float> boxes;
+    std::vector<uint8_t> expected;
+    std::size_t expected_total = 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        float base = static_cast<float>(i % 16) - 3.0f;
+        std::size_t axis = i % 3;
+        std::array<float, 6> box{1, 1, 1, 2, 2, 2};
+
+        box[axis] = base;
+        box[axis + 3] = base + 1.0f;
+
+        bool in = base <= view_max[axis] && base + 1.0f >= view_min[axis];
+
+        boxes.insert(boxes.end(), box.begin(), box.end());
+        expected.push_back(in ? 1 : 0);
+        expected_total += in;
+    }
+    for (ECS::SimdLevel level : runnableLevels()) {
+        std::vector<uint8_t> visible(count, 0xAA);
+
+        ECS::SimdDispatch::force(level);
+        CHECK(ECS::cullAabbBatch(boxes, view_min, view_max, visible) == expected_total);
+        CHECK(visible == expected);
+    }
+    ECS::SimdDispatch::force(ECS::detectSimdLevel());
+}
+
+TEST_CASE(integratePoolsFollowsTheEntities)
+{
+    ECS::ECS ecs;
+    std::vector<ECS::EntityID> entities;
+
+    ecs.registerComponent<Position>();
+    ecs.registerComponent<Velocity>();
+    for (int i = 0; i < 50; i++) {
+        entities.push_back(ecs.entityCreate());
+        ecs.entityAddComponent<Position>(entities.back()) = Position{static_cast<float>(i), 0, 0};
+    }
+    // Reverse order, every fifth entity doesn't move
+    for (int i = 49; i >= 0; i--) {
+        if (i % 5 != 0)
+            ecs.entityAddComponent<Velocity>(entities[i]) = Velocity{1, 2, static_cast<float>(i)};
+    }
+
+    ECS::ComponentPool<Position> &positions = ecs.getPool<Position>();
+    ECS::ComponentPool<Velocity> &velocities = ecs.getPool<Velocity>();
+
+    CHECK(ECS::integratePools(positions, velocities, 0.5f) > 1);
+    // Once both pools hold the same entities in the same order, a single run covers them
+    for (int i = 0; i < 50; i += 5)
+        ecs.entityRemoveComponent<Position>(entities[i]);
+    CHECK((ecs.alignPools<Position, Velocity>()));
+    CHECK(ECS::integratePools(positions, velocities, 0.5f) == 1);
+    for (int i = 0; i < 50; i++) {
+        if (i % 5 == 0) {
+            CHECK(!ecs.entityHasComponent<Position>(entities[i]));
+            continue;
+        }
+
+        const Position &position = ecs.entityGetComponent<Position>(entities[i]);
+
+        CHECK(position.x == static_cast<float>(i) + 1.0f);
+        CHECK(position.y == 2.0f);
+        CHECK(position.z == static_cast<float>(i));
+    }
+}
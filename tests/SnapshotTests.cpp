@@ -0,0 +1,263 @@
+/*
+ *  SnapshotTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstring>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Position { float x = 0; };
+    struct Score { int value = 0; };
+    struct Name { std::string value; };
+}
+
+template<>
+struct ECS::ComponentTraits<Score> {
+    static constexpr bool split_storage = true;
+};
+
+namespace {
+    // Where the Streamer system writes, a system is default constructed
+    std::vector<std::byte> *t_delta = nullptr;
+
+    void registerAll(ECS::ECS &ecs)
+    {
+        ecs.registerComponent<Position>();
+        ecs.registerComponent<Score>();
+    }
+
+    // Worlds match if they hold the same entities, groups and trivially copyable components
+    void checkSameWorld(ECS::ECS &expected, ECS::ECS &actual)
+    {
+        CHECK(expected.currentEntityCount() == actual.currentEntityCount());
+        CHECK(expected.getEntityGroup(static_cast<ECS::EntityGroup>(1)).size() == actual.getEntityGroup(static_cast<ECS::EntityGroup>(1)).size());
+        CHECK(expected.getEntitiesByComponentsAllOf<Position>() == actual.getEntitiesByComponentsAllOf<Position>());
+        CHECK(expected.getEntitiesByComponentsAllOf<Score>() == actual.getEntitiesByComponentsAllOf<Score>());
+        for (ECS::EntityID e : expected.getEntitiesByComponentsAllOf<Position>())
+            CHECK(expected.entityGetComponent<Position>(e).x == actual.entityGetComponent<Position>(e).x);
+        for (ECS::EntityID e : expected.getEntitiesByComponentsAllOf<Score>())
+            CHECK(expected.entityGetComponent<Score>(e).value == actual.entityGetComponent<Score>(e).value);
+    }
+
+    std::string snapshotOf(const ECS::ECS &ecs)
+    {
+        std::ostringstream out(std::ios::binary);
+
+        ecs.saveSnapshot(out);
+        return out.str();
+    }
+
+    std::span<const std::byte> bytesOf(const std::string &data)
+    {
+        return std::span<const std::byte>(reinterpret_cast<const std::byte *>(data.data()), data.size());
+    }
+
+    class Streamer : public ECS::ISystem {
+        public:
+            void Update(ECS::ECS &ecs, ECS::SystemID id, uint32_t) override
+            {
+                t_delta->clear();
+                ecs.writeDelta(*t_delta, id);
+            }
+    };
+}
+
+TEST_CASE(snapshotRoundTrip)
+{
+    ECS::ECS source;
+    ECS::ECS copy;
+
+    registerAll(source);
+    registerAll(copy);
+    for (int i = 0; i < 100; i++) {
+        ECS::EntityID e = source.entityCreate(i % 3 == 0 ? static_cast<ECS::EntityGroup>(1) : ECS::NONE);
+
+        source.entityAddComponent<Position>(e).x = static_cast<float>(i);
+        if (i % 2 == 0)
+            source.entityAddComponent<Score>(e).value = i;
+        if (i % 7 == 0)
+            source.entityDelete(e);
+    }
+    copy.loadSnapshot(bytesOf(snapshotOf(source)));
+    checkSameWorld(source, copy);
+
+    // Both worlds recycle the same IDs
+    CHECK(source.entityCreate() == copy.entityCreate());
+}
+
+TEST_CASE(truncatedSnapshotIsRejected)
+{
+    ECS::ECS source;
+
+    registerAll(source);
+    for (int i = 0; i < 20; i++)
+        source.entityAddComponent<Score>(source.entityCreate()).value = i;
+
+    std::string snapshot = snapshotOf(source);
+
+    for (std::size_t size = 0; size < snapshot.size(); size++) {
+        ECS::ECS copy;
+
+        registerAll(copy);
+        CHECK_THROWS(copy.loadSnapshot(bytesOf(snapshot.substr(0, size))), ECS::ERROR::SnapshotError);
+    }
+}
+
+TEST_CASE(corruptedSnapshotIsRejectedOrConsistent)
+{
+    ECS::ECS source;
+
+    registerAll(source);
+    for (int i = 0; i < 40; i++) {
+        ECS::EntityID e = source.entityCreate(i % 3 == 0 ? static_cast<ECS::EntityGroup>(1) : ECS::NONE);
+
+        source.entityAddComponent<Position>(e).x = static_cast<float>(i);
+        if (i % 2 == 0)
+            source.entityAddComponent<Score>(e).value = i;
+        if (i % 5 == 0)
+            source.entityDelete(e);
+    }
+
+    std::string snapshot = snapshotOf(source);
+    std::size_t accepted = 0;
+
+    // Single byte flips either get rejected or load a world that stays usable
+    for (std::size_t i = 0; i < snapshot.size(); i++) {
+        for (unsigned char flip : {0x01, 0x80, 0xFF}) {
+            std::string corrupted = snapshot;
+            ECS::ECS copy;
+
+            corrupted[i] = static_cast<char>(corrupted[i] ^ flip);
+            registerAll(copy);
+            try {
+                copy.loadSnapshot(bytesOf(corrupted));
+            } catch (const ECS::ERROR::SnapshotError &) {
+                continue;
+            }
+            accepted++;
+            for (ECS::EntityID e : copy.getEntitiesByComponentsAllOf<Score>())
+                copy.entityGetComponent<Score>(e).value++;
+            for (int group = 0; group < 2; group++) {
+                std::span<const ECS::EntityID> members = copy.getEntityGroup(static_cast<ECS::EntityGroup>(group));
+                std::vector<ECS::EntityID> entities(members.begin(), members.end());
+
+                for (ECS::EntityID e : entities)
+                    copy.entityDelete(e);
+            }
+            CHECK(copy.currentEntityCount() == 0);
+            CHECK(copy.getEntitiesByComponentsAllOf<Position>().empty());
+            for (int j = 0; j < 50; j++)
+                copy.entityAddComponent<Score>(copy.entityCreate());
+            CHECK(copy.getEntitiesByComponentsAllOf<Score>().size() == 50);
+        }
+    }
+    // Component values and padding are free to change
+    CHECK(accepted != 0);
+}
+
+TEST_CASE(snapshotRejectsNonTrivialComponents)
+{
+    ECS::ECS source;
+
+    source.registerComponent<Name>();
+    source.entityAddComponent<Name>(source.entityCreate()).value = "name";
+    CHECK_THROWS(snapshotOf(source), ECS::ERROR::SnapshotError);
+}
+
+TEST_CASE(deltaRoundTrip)
+{
+    ECS::ECS source;
+    ECS::ECS replica;
+    std::vector<std::byte> delta;
+    std::vector<ECS::EntityID> entities;
+
+    registerAll(source);
+    registerAll(replica);
+    t_delta = &delta;
+    source.addSystem<Streamer>();
+    for (int frame = 0; frame < 20; frame++) {
+        for (int i = 0; i < 10; i++) {
+            ECS::EntityID e = source.entityCreate(i % 4 == 0 ? static_cast<ECS::EntityGroup>(1) : ECS::NONE);
+
+            entities.push_back(e);
+            source.entityAddComponent<Position>(e).x = static_cast<float>(frame * 100 + i);
+            if (i % 2 != 0)
+                source.entityAddComponent<Score>(e).value = i;
+        }
+        for (std::size_t i = frame; i < entities.size(); i += 7) {
+            if (source.entityIsActive(entities[i]))
+                source.entityMarkChanged<Position>(entities[i]).x += 1;
+        }
+        for (std::size_t i = frame * 2; i < entities.size(); i += 11) {
+            if (source.entityHasComponent<Score>(entities[i]))
+                source.entityRemoveComponent<Score>(entities[i]);
+        }
+        for (std::size_t i = frame; i < entities.size(); i += 9) {
+            if (source.entityIsActive(entities[i]))
+                source.entityDelete(entities[i]);
+        }
+        source.Update();
+        replica.applyDelta(delta);
+        checkSameWorld(source, replica);
+    }
+
+    // The replica keeps creating its own entities after the deltas
+    CHECK(replica.entityIsActive(replica.entityCreate()));
+}
+
+TEST_CASE(truncatedDeltaIsRejected)
+{
+    ECS::ECS source;
+    std::vector<std::byte> delta;
+
+    registerAll(source);
+    t_delta = &delta;
+    source.addSystem<Streamer>();
+    for (int i = 0; i < 10; i++)
+        source.entityAddComponent<Position>(source.entityCreate()).x = static_cast<float>(i);
+    source.Update();
+    for (std::size_t size = 0; size < delta.size(); size++) {
+        ECS::ECS replica;
+
+        registerAll(replica);
+        CHECK_THROWS(replica.applyDelta(std::span<const std::byte>(delta).first(size)), ECS::ERROR::SnapshotError);
+    }
+
+    // The first creation's group, past the header, the empty deletion block and the creation count
+    std::size_t group_offset = 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t) + sizeof(ECS::EntityID);
+    uint32_t group = 0;
+
+    CHECK(group_offset + sizeof(group) <= delta.size());
+    std::memcpy(&group, delta.data() + group_offset, sizeof(group));
+    CHECK(group == ECS::NONE);
+    for (uint32_t corrupted : {ECS::ENTITY_GROUP_LIMIT, 0xFFFFFFFFu}) {
+        ECS::ECS replica;
+
+        registerAll(replica);
+        std::memcpy(delta.data() + group_offset, &corrupted, sizeof(corrupted));
+        CHECK_THROWS(replica.applyDelta(delta), ECS::ERROR::SnapshotError);
+    }
+}
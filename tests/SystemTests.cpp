@@ -0,0 +1,157 @@
+/*
+ *  SystemTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <chrono>
+#include <vector>
+
+#include "ECS.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    // What the systems saw, systems are default constructed
+    struct Run {
+        int system;
+        ECS::SystemID id;
+        uint32_t msecs;
+    };
+
+    std::vector<Run> t_runs;
+
+    template<int N>
+    struct Recorder {
+        void Update(ECS::ECS &, ECS::SystemID id, uint32_t msecs) { t_runs.push_back(Run{N, id, msecs}); }
+    };
+
+    template<int N>
+    class VirtualRecorder : public ECS::ISystem {
+        public:
+            void Update(ECS::ECS &, ECS::SystemID id, uint32_t msecs) override { t_runs.push_back(Run{N, id, msecs}); }
+    };
+
+    class BudgetedSystem : public ECS::ISystem {
+        public:
+            void Update(ECS::ECS &ecs, ECS::SystemID id, uint32_t) override
+            {
+                auto start = std::chrono::steady_clock::now();
+
+                // Gives up after a second, so that a budget that never runs out fails instead of hanging
+                while (!ecs.systemBudgetExhausted(id) && std::chrono::steady_clock::now() - start < std::chrono::seconds(1))
+                    s_steps++;
+                s_elapsed = std::chrono::steady_clock::now() - start;
+            }
+
+            static inline std::size_t s_steps = 0;
+            static inline std::chrono::steady_clock::duration s_elapsed{};
+    };
+}
+
+TEST_CASE(pipelineRunsInOrderWithItsOwnIds)
+{
+    ECS::ECS ecs;
+
+    t_runs.clear();
+
+    ECS::SystemID before = ecs.addSystem<VirtualRecorder<0>>();
+    ECS::SystemID first = ecs.addPipeline<Recorder<1>, Recorder<2>, Recorder<3>>();
+    ECS::SystemID after = ecs.addSystem<VirtualRecorder<4>>();
+
+    CHECK(before == 0);
+    CHECK(first == 1);
+    CHECK(after == 4);
+    ecs.Update(5);
+    CHECK(t_runs.size() == 5);
+    for (int i = 0; i < 5 && i < static_cast<int>(t_runs.size()); i++) {
+        CHECK(t_runs[i].system == i);
+        CHECK(t_runs[i].id == static_cast<ECS::SystemID>(i));
+        CHECK(t_runs[i].msecs == 5);
+    }
+
+    // Systems of a pipeline are toggled one by one
+    t_runs.clear();
+    ecs.toggleSystem(first + 1);
+    CHECK(!ecs.systemIsEnabled(first + 1));
+    ecs.Update();
+    CHECK(t_runs.size() == 4);
+    for (const Run &run : t_runs)
+        CHECK(run.system != 2);
+}
+
+TEST_CASE(pipelineTickrate)
+{
+    ECS::ECS ecs;
+
+    t_runs.clear();
+    ecs.addPipeline<Recorder<1>, Recorder<2>>(1);
+    for (int i = 0; i < 4; i++)
+        ecs.Update();
+    // Each system runs once every two ticks
+    CHECK(t_runs.size() == 4);
+}
+
+TEST_CASE(fixedTimestepAccumulates)
+{
+    ECS::ECS ecs;
+
+    t_runs.clear();
+
+    ECS::SystemID physics = ecs.addSystem<VirtualRecorder<0>>();
+
+    ecs.setSystemPeriod(physics, 10, 3);
+    ecs.Update(4);
+    CHECK(t_runs.empty());
+    CHECK(ecs.systemStepAlpha(physics) == 0.4f);
+    ecs.Update(8);
+    CHECK(t_runs.size() == 1);
+    CHECK(ecs.systemStepAlpha(physics) == 0.2f);
+    ecs.Update(25);
+    CHECK(t_runs.size() == 3);
+    CHECK(ecs.systemStepAlpha(physics) == 0.7f);
+
+    // A long frame runs max_steps steps at most, the rest is dropped
+    ecs.Update(100);
+    CHECK(t_runs.size() == 6);
+    for (const Run &run : t_runs)
+        CHECK(run.msecs == 10);
+    CHECK(ecs.systemStepAlpha(physics) < 1.0f);
+}
+
+TEST_CASE(timeBudgetRunsOut)
+{
+    ECS::ECS ecs;
+    ECS::SystemID budgeted = ecs.addSystem<BudgetedSystem>();
+
+    ecs.setSystemBudget(budgeted, std::chrono::milliseconds(2));
+    ecs.Update();
+    CHECK(BudgetedSystem::s_steps != 0);
+    CHECK(BudgetedSystem::s_elapsed >= std::chrono::milliseconds(1));
+    CHECK(BudgetedSystem::s_elapsed < std::chrono::seconds(1));
+
+    // Each run gets a fresh budget
+    BudgetedSystem::s_steps = 0;
+    ecs.Update();
+    CHECK(BudgetedSystem::s_steps != 0);
+    CHECK(BudgetedSystem::s_elapsed < std::chrono::seconds(1));
+
+    // Without a budget, it's never exhausted
+    ecs.setSystemBudget(budgeted, std::chrono::nanoseconds(0));
+    CHECK(!ecs.systemBudgetExhausted(budgeted));
+}
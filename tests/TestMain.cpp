@@ -0,0 +1,48 @@
+/*
+ *  TestMain
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <cstdio>
+#include <cstring>
+
+#include "TestUtils.hpp"
+
+// Runs every case, or those whose name contains argv[1], and fails if one of them did
+int main(int argc, char **argv)
+{
+    int failed = 0;
+    int ran = 0;
+
+    for (const test::Case &c : test::cases()) {
+        if (argc > 1 && std::strstr(c.name, argv[1]) == nullptr)
+            continue;
+        ran++;
+        try {
+            c.run();
+            std::printf("[ OK ] %s\n", c.name);
+        } catch (const std::exception &e) {
+            failed++;
+            std::printf("[FAIL] %s\n       %s\n", c.name, e.what());
+        }
+    }
+    std::printf("%d/%d passed\n", ran - failed, ran);
+    return failed != 0 || ran == 0;
+}
@@ -0,0 +1,94 @@
+/*
+ *  TestUtils
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#ifndef TESTUTILS_HPP_
+    #define TESTUTILS_HPP_
+
+#include <string>
+#include <vector>
+#include <exception>
+
+namespace test {
+
+    /**
+     * @brief A test case, registered by TEST_CASE() before main() runs
+     */
+    struct Case {
+        const char *name;
+        void (*run)();
+    };
+
+    /**
+     * @brief Thrown by CHECK() and CHECK_THROWS(), ends the current case
+     */
+    class Failure : public std::exception {
+        public:
+            Failure(const char *file, int line, const std::string &what)
+            : m_message(std::string(file) + ":" + std::to_string(line) + ": " + what)
+            {}
+
+            const char *what() const noexcept override { return m_message.c_str(); }
+
+        private:
+            std::string m_message;
+    };
+
+    /**
+     * @brief Returns every registered case, in registration order within a file
+     */
+    inline std::vector<Case> &cases()
+    {
+        static std::vector<Case> registered;
+
+        return registered;
+    }
+
+    struct Registration {
+        Registration(const char *name, void (*run)()) { cases().push_back(Case{name, run}); }
+    };
+}
+
+// Defines and registers a test case, the body follows the macro
+#define TEST_CASE(name) \
+    static void name(); \
+    static const test::Registration name##_registration(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+            throw test::Failure(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+    } while (0)
+
+#define CHECK_THROWS(expression, Error) \
+    do { \
+        bool thrown = false; \
+        try { \
+            expression; \
+        } catch (const Error &) { \
+            thrown = true; \
+        } \
+        if (!thrown) \
+            throw test::Failure(__FILE__, __LINE__, #expression " didn't throw " #Error); \
+    } while (0)
+
+#endif /* !TESTUTILS_HPP_ */
@@ -0,0 +1,110 @@
+/*
+ *  WorldTests
+ *
+ *  Blob ECS is a lightweight Entity Component System library
+ *  Copyright (C) 2025 LECOCQ Guillaume
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+*/
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "ECS.hpp"
+#include "WorldExecutor.hpp"
+#include "TestUtils.hpp"
+
+namespace {
+    struct Counter { uint32_t steps = 0; uint32_t msecs = 0; };
+    struct Poison {};
+
+    class CountingSystem : public ECS::ISystem {
+        public:
+            void Update(ECS::ECS &ecs, ECS::SystemID, uint32_t msecs) override
+            {
+                if (!ecs.getEntitiesByComponentsAllOf<Poison>().empty())
+                    throw std::runtime_error("poisoned world");
+                for (auto [e, counter] : ecs.view<Counter>()) {
+                    (void)e;
+                    counter.steps++;
+                    counter.msecs += msecs;
+                }
+            }
+    };
+
+    std::unique_ptr<ECS::ECS> makeWorld()
+    {
+        auto world = std::make_unique<ECS::ECS>();
+
+        world->registerComponent<Counter>();
+        world->registerComponent<Poison>();
+        world->addSystem<CountingSystem>();
+        world->entityAddComponent<Counter>(world->entityCreate());
+        return world;
+    }
+
+    const Counter &counterOf(ECS::ECS &world)
+    {
+        return world.entityGetComponent<Counter>(world.getEntitiesByComponentsAllOf<Counter>().front());
+    }
+}
+
+TEST_CASE(worldExecutorStepsEveryWorld)
+{
+    ECS::ThreadPool pool(3);
+    ECS::WorldExecutor executor(pool);
+    std::vector<std::unique_ptr<ECS::ECS>> worlds;
+
+    for (int i = 0; i < 8; i++) {
+        worlds.push_back(makeWorld());
+        CHECK(executor.addWorld(*worlds.back()) < pool.workerCount());
+    }
+    // Adding a world twice keeps its worker
+    CHECK(executor.addWorld(*worlds[0]) == executor.addWorld(*worlds[0]));
+    CHECK(executor.worldCount() == 8);
+
+    executor.Update(16);
+    executor.Update(16);
+    for (auto &world : worlds) {
+        CHECK(counterOf(*world).steps == 2);
+        CHECK(counterOf(*world).msecs == 32);
+    }
+
+    CHECK(executor.removeWorld(*worlds[3]));
+    CHECK(!executor.removeWorld(*worlds[3]));
+    CHECK(executor.worldCount() == 7);
+    executor.setAffinity(*worlds[0], pool.workerCount() + 1);
+    executor.Update(16);
+    for (std::size_t i = 0; i < worlds.size(); i++)
+        CHECK(counterOf(*worlds[i]).steps == (i == 3 ? 2u : 3u));
+}
+
+TEST_CASE(worldExecutorRethrowsAndFinishesTheStep)
+{
+    ECS::ThreadPool pool(2);
+    ECS::WorldExecutor executor(pool);
+    std::vector<std::unique_ptr<ECS::ECS>> worlds;
+
+    for (int i = 0; i < 4; i++) {
+        worlds.push_back(makeWorld());
+        executor.addWorld(*worlds.back());
+    }
+    worlds[2]->entityAddComponent<Poison>(worlds[2]->entityCreate());
+    CHECK_THROWS(executor.Update(), std::runtime_error);
+    for (std::size_t i = 0; i < worlds.size(); i++)
+        CHECK(counterOf(*worlds[i]).steps == (i == 2 ? 0u : 1u));
+}